@@ -11,8 +11,9 @@ uniform vec3 uLightColor;
 
 uniform sampler2D uDiffMap1;
 
-uniform bool applyGreen;
-uniform bool greenFilterOn;
+// permutacije (ShaderPermutations) umesto uniform grananja:
+//   APPLY_GREEN  - zelena nijansa za pojedinacne modele (putnik kome je muka)
+//   GREEN_FILTER - zeleni filter preko cele scene
 
 void main()
 {    
@@ -36,24 +37,21 @@ void main()
     vec4 texColor = texture(uDiffMap1, chUV);
     vec4 lighting = texColor * vec4(ambient + diffuse + specular, 1.0);
 
-    if (applyGreen) {
-        lighting.g = min(lighting.g * 1.5, 1.0); // pojacava zelenu komponentu ali max 1.0
-    }
-    
+#ifdef APPLY_GREEN
     // zelena nijansa za pojedinacne modele
-    if (applyGreen) {
-        lighting.g = min(lighting.g * 1.5, 1.0);
-    }
+    // pojacava zelenu komponentu ali max 1.0 (1.5 * 1.5, ranije se mnozilo sa 1.5 dva puta)
+    lighting.g = min(lighting.g * 2.25, 1.0);
+#endif
 
     FragColor = lighting;
 
+#ifdef GREEN_FILTER
     // filter preko cele scene
-    if (greenFilterOn) {
-        FragColor.rgb = vec3(
-            FragColor.r * 0.5,
-            min(FragColor.g * 1.5, 1.0),
-            FragColor.b * 0.5
-        );
-    }
+    FragColor.rgb = vec3(
+        FragColor.r * 0.5,
+        min(FragColor.g * 1.5, 1.0),
+        FragColor.b * 0.5
+    );
+#endif
 }
 
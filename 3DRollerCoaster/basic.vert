@@ -7,7 +7,11 @@ out vec3 chFragPos;
 out vec3 chNormal;
 out vec2 chUV;
 
-uniform mat4 uM;
+// matrica objekta je u uniform bloku (CommandReplayer pomera offset u zajednickom UBO-u po komandi)
+layout (std140) uniform Object
+{
+    mat4 uM;
+};
 uniform mat4 uV;
 uniform mat4 uP;
 
@@ -0,0 +1,940 @@
+#include "benchmarks.hpp"
+#include "cart_motion.hpp"
+#include "command_buffer.hpp"
+#include "gpu_rails.hpp"
+#include "job_system.hpp"
+#include "passenger.hpp"
+#include "path.hpp"
+#include "ride_controller.hpp"
+#include "shader_permutations.hpp"
+#include "track_bundle.hpp"
+#include "track_generator.hpp"
+#include "scene_snapshot.hpp"
+#include "sweep_builder.hpp"
+#include "triple_buffer.hpp"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using BenchClock = std::chrono::steady_clock;
+
+static double elapsedMicroseconds(BenchClock::time_point from, BenchClock::time_point to) {
+    return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+int runTripleBufferStress(double seconds) {
+    // objavljivanje i citanje su jedna atomska zamena indeksa (desetine ns); duze od SLOW_US znaci da je nit
+    // cekala (na drugu nit ili na raspored), a to sme da bude samo retko (kad OS prekine nit usred operacije)
+    const double SLOW_US = 100.0;
+    const double MAX_SLOW_FRACTION = 0.001;
+
+    TripleBuffer<SceneSnapshot> buffer;
+    std::atomic<bool> running{ true };
+
+    long long published = 0, slowPublishes = 0;
+    double maxPublishUs = 0.0;
+
+    long long reads = 0, newReads = 0, torn = 0, outOfOrder = 0, slowReads = 0;
+    double maxReadUs = 0.0;
+
+    // pisac: svako polje snapshot-a nosi isti redni broj, pa se polovican upis odmah vidi
+    std::thread writer([&]() {
+        while (running.load(std::memory_order_relaxed)) {
+            long long tick = published + 1;
+            SceneSnapshot& snapshot = buffer.writeBuffer();
+            snapshot.tick = tick;
+            snapshot.tickTime = (double)tick;
+            snapshot.prevT = (float)(tick % 100000);
+            snapshot.t = (float)(tick % 100000);
+            for (PassengerSnapshot& passenger : snapshot.passengers)
+                passenger.isActive = passenger.isSick = passenger.isBeltOn = (tick % 2) == 0;
+
+            BenchClock::time_point start = BenchClock::now();
+            buffer.publish();
+            double publishUs = elapsedMicroseconds(start, BenchClock::now());
+            maxPublishUs = std::max(maxPublishUs, publishUs);
+            if (publishUs > SLOW_US) slowPublishes++;
+            published = tick;
+        }
+    });
+
+    // citalac: preuzima snapshot-e i proverava konzistentnost i redosled
+    std::thread reader([&]() {
+        long long lastTick = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            BenchClock::time_point start = BenchClock::now();
+            bool fresh = buffer.update();
+            double readUs = elapsedMicroseconds(start, BenchClock::now());
+            maxReadUs = std::max(maxReadUs, readUs);
+            if (readUs > SLOW_US) slowReads++;
+            reads++;
+            if (!fresh) continue;
+            newReads++;
+
+            const SceneSnapshot& snapshot = buffer.readBuffer();
+            bool consistent = snapshot.tickTime == (double)snapshot.tick &&
+                snapshot.t == (float)(snapshot.tick % 100000) &&
+                snapshot.prevT == snapshot.t;
+            for (const PassengerSnapshot& passenger : snapshot.passengers)
+                consistent = consistent && passenger.isActive == ((snapshot.tick % 2) == 0) &&
+                    passenger.isSick == passenger.isActive && passenger.isBeltOn == passenger.isActive;
+            if (!consistent) torn++;
+            if (snapshot.tick <= lastTick) outOfOrder++;
+            lastTick = snapshot.tick;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running.store(false);
+    writer.join();
+    reader.join();
+
+    bool waitFree = slowPublishes <= published * MAX_SLOW_FRACTION && slowReads <= reads * MAX_SLOW_FRACTION;
+    std::cout << "Trostruki bafer (" << seconds << " s):\n"
+        << "  objavljeno snapshot-a: " << published << " (" << published / seconds << " /s), najduze objavljivanje " << maxPublishUs
+        << " us, duzih od " << SLOW_US << " us: " << slowPublishes << "\n"
+        << "  citanja: " << reads << ", novih snapshot-a: " << newReads << ", najduze citanje " << maxReadUs
+        << " us, duzih od " << SLOW_US << " us: " << slowReads << "\n"
+        << "  polovicnih snapshot-a: " << torn << ", snapshot-a van redosleda: " << outOfOrder << "\n"
+        << "  bez cekanja (najvise " << MAX_SLOW_FRACTION * 100.0 << "% sporih operacija na svakoj strani): "
+        << (waitFree ? "da" : "NE") << "\n";
+    return (torn == 0 && outOfOrder == 0 && waitFree) ? 0 : 1;
+}
+
+int runHeadlessRides(int rides) {
+    // ista putanja kao u prozorskom modu
+    Path path(40.0f, 3.0f, 1.0f, 4.0f, 3, glm::vec3(-20, 0, 0));
+
+    std::vector<Passenger> seats;
+    for (int i = 0; i < 8; i++)
+        seats.emplace_back(i);
+    std::vector<Passenger*> passengers;
+    for (Passenger& passenger : seats)
+        passengers.push_back(&passenger);
+
+    RideController rideController(passengers);
+    CartMotion cartMotion(&path, &rideController);
+
+    // najvise koraka po voznji pre nego sto proglasimo da je simulacija zaglavljena
+    const long long MAX_STEPS_PER_RIDE = 1000000;
+    unsigned int seed = 12345;
+    auto random = [&seed](unsigned int range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 16) % range;
+    };
+
+    long long totalSteps = 0;
+    int completedRides = 0, sickRides = 0;
+    BenchClock::time_point start = BenchClock::now();
+
+    for (int ride = 0; ride < rides; ride++) {
+        // ukrcavanje i vezivanje
+        int count = 1 + (int)random(8);
+        for (int i = 0; i < count; i++)
+            rideController.addPassanger();
+        for (int i = 0; i < count; i++)
+            rideController.passangerInteraction(i);
+        rideController.rideStarted();
+        if (rideController.getRideState() != RideState::ACTIVE) {
+            std::cout << "Voznja " << ride << " nije pocela\n";
+            return 1;
+        }
+
+        // svaka deseta voznja: nekome se slosi posle nasumicnog broja koraka
+        long long sickAtStep = (random(10) == 0) ? 100 + random(1500) : -1;
+        long long steps = 0;
+        while (rideController.getRideState() == RideState::ACTIVE ||
+            rideController.getRideState() == RideState::SOMEONE_SICK) {
+            if (steps == sickAtStep) {
+                rideController.passangerInteraction((int)random(count));
+                sickRides++;
+            }
+            cartMotion.step();
+            if (++steps > MAX_STEPS_PER_RIDE) {
+                std::cout << "Voznja " << ride << " se nije zavrsila posle " << steps << " koraka\n";
+                return 1;
+            }
+        }
+        totalSteps += steps;
+
+        // iskrcavanje
+        for (int i = 0; i < count; i++)
+            rideController.passangerInteraction(i);
+        if (rideController.getRideState() != RideState::READY || rideController.getNumberOfPassangers() != 0) {
+            std::cout << "Posle voznje " << ride << " kola nisu spremna\n";
+            return 1;
+        }
+        // jedan korak u READY stanju vraca kola na pocetak staze
+        cartMotion.step();
+        totalSteps++;
+        completedRides++;
+    }
+
+    double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+    double simulatedSeconds = totalSteps * CartMotion::FIXED_DT;
+    std::cout << "Headless simulacija:\n"
+        << "  voznji: " << completedRides << " (sa mucninom " << sickRides << "), koraka: " << totalSteps << "\n"
+        << "  simulirano " << simulatedSeconds << " s za " << seconds * 1000.0 << " ms"
+        << " (" << simulatedSeconds / std::max(seconds, 1e-9) << "x realnog vremena)\n"
+        << "  " << completedRides / std::max(seconds, 1e-9) << " voznji/s, "
+        << totalSteps / std::max(seconds, 1e-9) << " koraka/s, prosecna voznja "
+        << simulatedSeconds / std::max(completedRides, 1) << " s\n";
+    return 0;
+}
+
+// FNV-1a nad bajtovima cele geometrije (za poredjenje bez cuvanja dve kopije)
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t hashTrack(const TrackGeometry& geometry) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const TrackPart* part : { &geometry.rails, &geometry.planks, &geometry.sleepers }) {
+        hash = hashBytes(hash, part->vertices.data(), part->vertices.size() * sizeof(Vertex));
+        hash = hashBytes(hash, part->indices.data(), part->indices.size() * sizeof(unsigned int));
+    }
+    return hash;
+}
+
+// najbolje vreme od nekoliko ponavljanja (u ms) i hes poslednjeg rezultata
+static double timeTrackGeneration(const TrackGenerator& generator, JobSystem* jobSystem, int repeats, uint64_t& hash) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; r++) {
+        BenchClock::time_point start = BenchClock::now();
+        TrackGeometry geometry = generator.generate(jobSystem);
+        double ms = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+        best = (r == 0) ? ms : std::min(best, ms);
+        if (r == repeats - 1)
+            hash = hashTrack(geometry);
+    }
+    return best;
+}
+
+int runTrackGenerationBench() {
+    // ista putanja i dimenzije staze kao u prozorskom modu
+    Path path(40.0f, 3.0f, 1.0f, 4.0f, 3, glm::vec3(-20, 0, 0));
+    int cores = std::max(1, (int)std::thread::hardware_concurrency());
+    bool identical = true;
+
+    // uvek bar do 4 niti (provera da je rezultat identican), ubrzanje se racuna samo do broja jezgara
+    int maxThreads = std::max(cores, 4);
+    std::cout << "Generisanje staze (jezgara: " << cores << "):\n";
+    if (cores < 2)
+        std::cout << "  samo jedno jezgro: ubrzanje sa vise niti ovde ne moze da se izmeri, meri se samo cena poslova\n";
+    for (int samples : { 5000, 50000, 500000 }) {
+        TrackGenerator generator(&path, 1.2f, 0.2f, samples);
+        int repeats = std::max(1, 100000 / samples);
+
+        uint64_t serialHash = 0;
+        double serialMs = timeTrackGeneration(generator, nullptr, repeats, serialHash);
+        std::cout << "  uzoraka " << samples << ": redom " << serialMs << " ms\n";
+
+        // niti = radnici + pozivajuca nit (koja radi svoj deo u parallelFor/wait)
+        for (int threads = 2; threads <= maxThreads; threads *= 2) {
+            JobSystem jobSystem(threads - 1);
+            uint64_t parallelHash = 0;
+            double parallelMs = timeTrackGeneration(generator, &jobSystem, repeats, parallelHash);
+            bool same = parallelHash == serialHash;
+            identical = identical && same;
+            double speedup = serialMs / std::max(parallelMs, 1e-9);
+            std::cout << "    " << threads << " niti: " << parallelMs << " ms, ubrzanje " << speedup << "x";
+            // efikasnost = ubrzanje / broj niti koje zaista mogu da rade istovremeno (linearno = 100%)
+            if (threads <= cores)
+                std::cout << " (efikasnost " << speedup / threads * 100.0 << "%)";
+            else
+                std::cout << " (vise niti nego jezgara)";
+            std::cout << ", rezultat " << (same ? "identican" : "RAZLIKUJE SE") << "\n";
+        }
+    }
+    return identical ? 0 : 1;
+}
+
+int runPathDerivativeCheck() {
+    Path path(40.0f, 3.0f, 1.0f, 4.0f, 3, glm::vec3(-20, 0, 0));
+
+    // stara tangenta (pre analitickih izvoda): razlika dve tacke, na kraju putanje nula vektor
+    auto oldTangent = [&path](float t) {
+        glm::vec3 p1 = path.getPoint(t);
+        glm::vec3 p2 = path.getPoint(std::min(t + 0.001f, 1.0f));
+        return glm::normalize(p2 - p1);
+    };
+
+    // 1) tacnost: centralne razlike unutar segmenata (na spojevima drugi izvod ima skok;
+    //    0.08 je pocetak brda unutar prvog segmenta)
+    const float joints[] = { 0.0f, 0.08f, 0.40f, 0.50f, 0.90f, 1.0f };
+    const float h = 1e-4f;      // korak za prvi izvod
+    const float h2 = 1e-3f;     // korak za drugi izvod (manji korak u float-u daje samo sum)
+    const int SAMPLES = 20000;
+    double maxTangentAngle = 0.0, maxCurvatureError = 0.0, maxCurvature = 0.0;
+    int checked = 0;
+    for (int i = 0; i <= SAMPLES; i++) {
+        float t = float(i) / SAMPLES;
+        bool nearJoint = false;
+        for (float joint : joints)
+            nearJoint = nearJoint || std::abs(t - joint) < 2.0f * h2;
+        if (nearJoint)
+            continue;
+        checked++;
+
+        glm::vec3 fdD1 = (path.getPoint(t + h) - path.getPoint(t - h)) / (2.0f * h);
+        glm::vec3 fdD2 = (path.getPoint(t + h2) - 2.0f * path.getPoint(t) + path.getPoint(t - h2)) / (h2 * h2);
+        float cosAngle = glm::dot(glm::normalize(fdD1), path.getTangent(t));
+        maxTangentAngle = std::max(maxTangentAngle, (double)std::acos(std::min(cosAngle, 1.0f)));
+
+        float fdSpeed = glm::length(fdD1);
+        float fdCurvature = glm::length(glm::cross(fdD1, fdD2)) / (fdSpeed * fdSpeed * fdSpeed);
+        float curvature = path.getCurvature(t);
+        maxCurvature = std::max(maxCurvature, (double)curvature);
+        maxCurvatureError = std::max(maxCurvatureError, (double)std::abs(curvature - fdCurvature));
+    }
+
+    // 2) kraj putanje: stara tangenta je NaN, nova mora biti konacna i jedinicna
+    glm::vec3 endTangent = path.getTangent(1.0f);
+    glm::vec3 oldEndTangent = oldTangent(1.0f);
+    bool endFinite = std::isfinite(endTangent.x) && std::isfinite(endTangent.y) && std::isfinite(endTangent.z) &&
+        std::abs(glm::length(endTangent) - 1.0f) < 1e-5f;
+    bool oldEndFinite = std::isfinite(oldEndTangent.x) && std::isfinite(oldEndTangent.y) && std::isfinite(oldEndTangent.z);
+
+    // 3) brzina: isti niz t-ova za obe varijante, zbir komponenti da kompajler ne izbaci racun
+    const int QUERIES = 2000000;
+    float sink = 0.0f;
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < QUERIES; i++) {
+        glm::vec3 T = oldTangent(float(i) / QUERIES);
+        sink += T.x + T.y + T.z;
+    }
+    double oldMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+    start = BenchClock::now();
+    for (int i = 0; i < QUERIES; i++) {
+        glm::vec3 T = path.getTangent(float(i) / QUERIES);
+        sink += T.x + T.y + T.z;
+    }
+    double newMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+    start = BenchClock::now();
+    for (int i = 0; i < QUERIES; i++)
+        sink += path.getCurvature(float(i) / QUERIES);
+    double curvatureMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+
+    // granice su nekoliko puta iznad greske konacnih razlika u float-u
+    const double MAX_TANGENT_ANGLE = 1e-3;
+    const double MAX_CURVATURE_ERROR = 1e-2 * std::max(maxCurvature, 1.0);
+    bool accurate = maxTangentAngle < MAX_TANGENT_ANGLE && maxCurvatureError < MAX_CURVATURE_ERROR;
+
+    std::cout << "Izvodi putanje (" << checked << " tacaka):\n"
+        << "  najveci ugao tangente prema konacnim razlikama: " << maxTangentAngle << " rad\n"
+        << "  najveca greska krivine: " << maxCurvatureError << " (najveca krivina " << maxCurvature << " 1/m)\n"
+        << "  tangenta na kraju putanje: " << (endFinite ? "ispravna" : "NEISPRAVNA")
+        << " (stara: " << (oldEndFinite ? "konacna" : "NaN") << ")\n"
+        << "  " << QUERIES << " tangenti: stara " << oldMs << " ms, analiticka " << newMs << " ms (ubrzanje "
+        << oldMs / std::max(newMs, 1e-9) << "x), krivina " << curvatureMs << " ms\n"
+        << "  (kontrolni zbir " << sink << ")\n";
+    return (accurate && endFinite) ? 0 : 1;
+}
+
+int runPathBatchBench() {
+    Path path(40.0f, 3.0f, 1.0f, 4.0f, 3, glm::vec3(-20, 0, 0));
+    const int COUNT = 1 << 20;
+    const int REPEATS = 5;
+    std::vector<float> ts(COUNT);
+    for (int i = 0; i < COUNT; i++)
+        ts[i] = float(i) / COUNT;
+
+    std::vector<glm::vec3> scalarPoints(COUNT), batchPoints(COUNT);
+    std::vector<glm::vec3> scalarTangents(COUNT), batchTangents(COUNT);
+    std::vector<PathFrame> scalarFrames(COUNT), batchFrames(COUNT);
+
+    // najbolje od REPEATS merenja, u milionima t-ova po sekundi
+    auto measure = [&](const std::function<void()>& body) {
+        double best = 1e30;
+        for (int r = 0; r < REPEATS; r++) {
+            BenchClock::time_point start = BenchClock::now();
+            body();
+            best = std::min(best, elapsedMicroseconds(start, BenchClock::now()));
+        }
+        return COUNT / std::max(best, 1e-9);
+    };
+
+    double scalarPointRate = measure([&]() {
+        for (int i = 0; i < COUNT; i++)
+            scalarPoints[i] = path.getPoint(ts[i]);
+    });
+    double batchPointRate = measure([&]() { path.getPoints(ts.data(), batchPoints.data(), COUNT); });
+    double scalarTangentRate = measure([&]() {
+        for (int i = 0; i < COUNT; i++)
+            scalarTangents[i] = path.getTangent(ts[i]);
+    });
+    double batchTangentRate = measure([&]() { path.getTangents(ts.data(), batchTangents.data(), COUNT); });
+    double scalarFrameRate = measure([&]() {
+        for (int i = 0; i < COUNT; i++)
+            scalarFrames[i] = path.getFrame(ts[i]);
+    });
+    double batchFrameRate = measure([&]() { path.getFrames(ts.data(), batchFrames.data(), COUNT); });
+
+    double maxPointError = 0.0, maxTangentError = 0.0, maxFrameError = 0.0;
+    for (int i = 0; i < COUNT; i++) {
+        maxPointError = std::max(maxPointError, (double)glm::length(batchPoints[i] - scalarPoints[i]));
+        maxTangentError = std::max(maxTangentError, (double)glm::length(batchTangents[i] - scalarTangents[i]));
+        maxFrameError = std::max(maxFrameError, (double)glm::length(batchFrames[i].position - scalarFrames[i].position));
+        maxFrameError = std::max(maxFrameError, (double)glm::length(batchFrames[i].normal - scalarFrames[i].normal));
+        maxFrameError = std::max(maxFrameError, (double)glm::length(batchFrames[i].binormal - scalarFrames[i].binormal));
+    }
+
+    // pozicije su do ~50 m, pa je 1e-4 m nekoliko puta iznad float greske
+    bool same = maxPointError < 1e-4 && maxTangentError < 1e-5 && maxFrameError < 1e-4;
+    std::cout << "Putanja, " << COUNT << " t-ova (miliona po sekundi, pojedinacno -> grupno):\n"
+        << "  tacke:    " << scalarPointRate << " -> " << batchPointRate << " (" << batchPointRate / scalarPointRate << "x)\n"
+        << "  tangente: " << scalarTangentRate << " -> " << batchTangentRate << " (" << batchTangentRate / scalarTangentRate << "x)\n"
+        << "  okviri:   " << scalarFrameRate << " -> " << batchFrameRate << " (" << batchFrameRate / scalarFrameRate << "x)\n"
+        << "  najveca razlika: tacke " << maxPointError << " m, tangente " << maxTangentError
+        << ", okviri " << maxFrameError << (same ? "" : " - PREVELIKA") << "\n";
+    return same ? 0 : 1;
+}
+
+// sintetisana zatvorena staza od kontrolnih tacaka: krug sa talasima visine i nagiba
+static PathParams makeWavyCircleTrack(int controlPoints, float radius, float height, float waveHeight, float waves,
+    float bankAngle, float bankWaves) {
+    PathParams params;
+    for (int i = 0; i < controlPoints; i++) {
+        float angle = 2.0f * glm::pi<float>() * i / controlPoints;
+        TrackControlPoint point;
+        point.position = glm::vec3(radius * std::cos(angle), height + waveHeight * std::sin(waves * angle), radius * std::sin(angle));
+        point.bank = bankAngle * std::sin(bankWaves * angle);
+        params.controlPoints.push_back(point);
+    }
+    return params;
+}
+
+int runSplinePathCheck(const std::string& trackFile) {
+    PathParams params;
+    params.origin = glm::vec3(-20, 0, 0);
+    if (!Path::loadControlPoints(trackFile, params.controlPoints))
+        return 2;
+    Path path(params);
+    const int segments = (int)params.controlPoints.size();
+
+    // 1) tangenta prema centralnim razlikama i skok tangente na spojevima segmenata (Catmull-Rom je C1)
+    const float h = 1e-4f;
+    const int SAMPLES = 20000;
+    double maxTangentAngle = 0.0, maxJointAngle = 0.0;
+    for (int i = 1; i < SAMPLES; i++) {
+        float t = float(i) / SAMPLES;
+        glm::vec3 fdD1 = (path.getPoint(t + h) - path.getPoint(t - h)) / (2.0f * h);
+        float cosAngle = glm::dot(glm::normalize(fdD1), path.getTangent(t));
+        maxTangentAngle = std::max(maxTangentAngle, (double)std::acos(std::min(cosAngle, 1.0f)));
+    }
+    for (int i = 1; i < segments; i++) {
+        float joint = float(i) / segments;
+        float cosAngle = glm::dot(path.getTangent(joint - 1e-6f), path.getTangent(joint + 1e-6f));
+        maxJointAngle = std::max(maxJointAngle, (double)std::acos(std::min(cosAngle, 1.0f)));
+    }
+
+    // 2) zatvorena staza: poza na kraju mora biti ista kao na pocetku (q i -q su ista rotacija)
+    PathPose first = path.getPose(0.0f), last = path.getPose(1.0f);
+    float seamDistance = glm::length(last.position - first.position);
+    float seamAngle = 2.0f * std::acos(std::min(std::abs(glm::dot(first.orientation, last.orientation)), 1.0f));
+
+    const double MAX_TANGENT_ANGLE = 2e-3;
+    const double MAX_JOINT_ANGLE = 1e-3;
+    bool accurate = maxTangentAngle < MAX_TANGENT_ANGLE && maxJointAngle < MAX_JOINT_ANGLE &&
+        seamDistance < 1e-3f && seamAngle < 1e-3f;
+
+    std::cout << "Staza " << trackFile << " (" << segments << " kontrolnih tacaka, duzina " << path.getTotalLength() << " m):\n"
+        << "  najveci ugao tangente prema konacnim razlikama: " << maxTangentAngle << " rad\n"
+        << "  najveci skok tangente na spojevima: " << maxJointAngle << " rad\n"
+        << "  kraj prema pocetku: " << seamDistance << " m, " << seamAngle << " rad" << (accurate ? "" : " - NEISPRAVNO") << "\n";
+
+    // 3) cena upita u zavisnosti od broja tacaka: sintetisana zatvorena staza (krug sa talasima i nagibom)
+    const int QUERIES = 1000000;
+    float sink = 0.0f;
+    std::cout << "  upiti (" << QUERIES << " slucajnih t-ova, ns po upitu):\n";
+    for (int count : { 16, 1000, 10000 }) {
+        PathParams synthetic = makeWavyCircleTrack(count, 2.0f * count, 3.0f, 2.0f, 8.0f, 10.0f, 4.0f);
+        BenchClock::time_point start = BenchClock::now();
+        Path large(synthetic);
+        double buildMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+
+        // isti pseudo-slucajni niz za sve velicine (skokovi po celoj stazi, ne redom)
+        std::vector<float> ts(QUERIES);
+        uint32_t state = 12345u;
+        for (float& t : ts) {
+            state = state * 1664525u + 1013904223u;
+            t = (state >> 8) * (1.0f / 16777216.0f);
+        }
+        auto measure = [&](const std::function<void(float)>& query) {
+            BenchClock::time_point from = BenchClock::now();
+            for (float t : ts)
+                query(t);
+            return elapsedMicroseconds(from, BenchClock::now()) * 1000.0 / QUERIES;
+        };
+        double pointNs = measure([&](float t) { glm::vec3 p = large.getPoint(t); sink += p.x + p.y + p.z; });
+        double poseNs = measure([&](float t) { PathPose pose = large.getPose(t); sink += pose.position.x + pose.orientation.w; });
+        double distanceNs = measure([&](float t) {
+            glm::vec3 p = large.getPointAtDistance(t * large.getTotalLength());
+            sink += p.x + p.y + p.z;
+        });
+        std::cout << "    " << count << " tacaka: getPoint " << pointNs << ", getPose " << poseNs
+            << ", getPointAtDistance " << distanceNs << " (pravljenje tabela " << buildMs << " ms)\n";
+    }
+    std::cout << "  (kontrolni zbir " << sink << ")\n";
+    return accurate ? 0 : 1;
+}
+
+int runTrackBundleBench() {
+    // ~10 km zatvorena staza: krug sa talasima i nagibom, 5 cm izmedju uzoraka geometrije
+    const int CONTROL_POINTS = 2000;
+    const float TRACK_LENGTH = 10000.0f;
+    const int SAMPLES = 200000;
+    const char* FILE_NAME = "track_bundle_bench.rctb";
+    PathParams params = makeWavyCircleTrack(CONTROL_POINTS, TRACK_LENGTH / (2.0f * glm::pi<float>()), 4.0f, 3.0f, 40.0f, 15.0f, 20.0f);
+    JobSystem jobSystem;
+
+    // 1) bez pecene staze: tabele putanje i geometrija (paralelno, kao u prozorskom modu)
+    BenchClock::time_point start = BenchClock::now();
+    Path path(params);
+    TrackGeometry geometry = TrackGenerator(&path, 1.2f, 0.2f, SAMPLES).generate(&jobSystem);
+    double buildMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+
+    TrackPartView parts[TrackBundle::PART_COUNT] = {
+        TrackBundle::view(geometry.rails), TrackBundle::view(geometry.planks), TrackBundle::view(geometry.sleepers)
+    };
+    start = BenchClock::now();
+    if (!TrackBundle::write(FILE_NAME, path, 1.2f, 0.2f, SAMPLES, TrackTessellation(), parts))
+        return 2;
+    double writeMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+
+    // 2) obicno citanje celog fajla u memoriju (donja granica za bilo kakvo ucitavanje)
+    start = BenchClock::now();
+    std::ifstream in(FILE_NAME, std::ios::binary | std::ios::ate);
+    std::vector<char> raw((size_t)in.tellg());
+    in.seekg(0);
+    in.read(raw.data(), raw.size());
+    in.close();
+    double readMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+
+    // 3) pecena staza: mapiranje, provera checksum-a i kopija tabela putanje (upload u GL nije deo merenja)
+    start = BenchClock::now();
+    TrackBundle bundle;
+    bool loaded = bundle.open(FILE_NAME) && bundle.matches(params, 1.2f, 0.2f, SAMPLES, TrackTessellation());
+    Path restored = loaded ? Path(params, bundle.getPathTables()) : Path(params);
+    double loadMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+
+    bool same = loaded;
+    if (loaded) {
+        TrackGeometry mapped;
+        TrackPart* mappedParts[TrackBundle::PART_COUNT] = { &mapped.rails, &mapped.planks, &mapped.sleepers };
+        for (int part = 0; part < TrackBundle::PART_COUNT; part++) {
+            TrackPartView view = bundle.getPart(part);
+            mappedParts[part]->vertices.assign(view.vertices, view.vertices + view.vertexCount);
+            mappedParts[part]->indices.assign(view.indices, view.indices + view.indexCount);
+        }
+        same = hashTrack(mapped) == hashTrack(geometry);
+        for (int i = 0; i <= 1000 && same; i++) {
+            float t = i / 1000.0f;
+            PathPose a = path.getPose(t), b = restored.getPose(t);
+            same = a.position == b.position && a.orientation == b.orientation &&
+                path.getTAtDistance(t * path.getTotalLength()) == restored.getTAtDistance(t * restored.getTotalLength());
+        }
+    }
+    bundle.close();
+
+    // 4) osteceni fajl (jedan bajt u sredini geometrije) mora biti odbacen
+    {
+        std::fstream file(FILE_NAME, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(raw.size() / 2);
+        file.put((char)(raw[raw.size() / 2] ^ 0x5a));
+    }
+    std::cout << "  (ocekivano odbijanje) ";
+    bool rejected = !bundle.open(FILE_NAME);
+    std::remove(FILE_NAME);
+
+    std::cout << "Pecena staza (" << path.getTotalLength() / 1000.0f << " km, " << CONTROL_POINTS << " kontrolnih tacaka, "
+        << SAMPLES << " uzoraka, fajl " << raw.size() / (1024.0 * 1024.0) << " MB):\n"
+        << "  pravljenje: " << buildMs << " ms, upis " << writeMs << " ms\n"
+        << "  obicno citanje fajla: " << readMs << " ms\n"
+        << "  mapiranje + checksum + tabele putanje: " << loadMs << " ms (" << buildMs / std::max(loadMs, 1e-9)
+        << "x brze od pravljenja)\n"
+        << "  ucitano " << (same ? "isto kao napravljeno" : "RAZLIKUJE SE") << ", osteceni fajl "
+        << (rejected ? "odbijen" : "PRIHVACEN") << "\n";
+    return (same && rejected) ? 0 : 1;
+}
+
+// ugradjena staza i staza iz fajla (ako se ucita), sa imenom za ispis
+static std::vector<std::pair<std::string, PathParams>> builtInAndFileTracks(const std::string& trackFile) {
+    PathParams builtIn;
+    builtIn.origin = glm::vec3(-20, 0, 0);
+    PathParams fromFile = builtIn;
+    std::vector<std::pair<std::string, PathParams>> tracks = { { "ugradjena staza", builtIn } };
+    if (Path::loadControlPoints(trackFile, fromFile.controlPoints))
+        tracks.push_back({ trackFile, fromFile });
+    return tracks;
+}
+
+// najvece rastojanje stvarne sine (obe strane) od tetiva izmedju susednih cvorova, 16 tacaka po kvadru
+static float measureRailDeviation(const Path& path, const TrackGenerator& generator, const std::vector<float>& knots) {
+    const int PROBES = 16;
+    std::vector<float> ts;
+    for (size_t k = 0; k + 1 < knots.size(); k++)
+        for (int probe = 0; probe <= PROBES; probe++)
+            ts.push_back(knots[k] + (knots[k + 1] - knots[k]) * probe / PROBES);
+    std::vector<PathFrame> frames(ts.size());
+    path.getFrames(ts.data(), frames.data(), (int)ts.size());
+
+    float deviation = 0.0f;
+    for (size_t k = 0; k + 1 < knots.size(); k++) {
+        const PathFrame* segment = &frames[k * (PROBES + 1)];
+        for (int side = -1; side <= 1; side += 2) {
+            glm::vec3 a = generator.railPoint(segment[0], side);
+            glm::vec3 ab = generator.railPoint(segment[PROBES], side) - a;
+            float length2 = std::max(glm::dot(ab, ab), 1e-12f);
+            for (int probe = 1; probe < PROBES; probe++) {
+                glm::vec3 p = generator.railPoint(segment[probe], side);
+                float f = std::clamp(glm::dot(p - a, ab) / length2, 0.0f, 1.0f);
+                deviation = std::max(deviation, glm::length(p - (a + ab * f)));
+            }
+        }
+    }
+    return deviation;
+}
+
+int runTrackTessellationBench(const std::string& trackFile) {
+    const int SAMPLES = 5000;       // mreza kandidata, isto kao u prozorskom modu
+    const float MAX_SEGMENT_LENGTH = 2.0f;
+    const int VERTICES_PER_SEGMENT = 2 * 24;    // dve sine po kvadar
+
+    std::vector<std::pair<std::string, PathParams>> tracks = builtInAndFileTracks(trackFile);
+
+    bool reduced = true;
+    for (const auto& track : tracks) {
+        Path path(track.second);
+        TrackGenerator uniform(&path, 1.2f, 0.2f, SAMPLES);
+        float uniformDeviation = measureRailDeviation(path, uniform, uniform.getRailKnots());
+        std::cout << track.first << " (" << path.getTotalLength() << " m), ravnomerno " << SAMPLES << " kvadara po sini: "
+            << SAMPLES * VERTICES_PER_SEGMENT << " verteksa, odstupanje " << uniformDeviation * 1000.0f << " mm\n";
+
+        for (float tolerance : { uniformDeviation, 0.002f, 0.01f }) {
+            TrackTessellation tessellation;
+            tessellation.tolerance = tolerance;
+            tessellation.maxSegmentLength = MAX_SEGMENT_LENGTH;
+            TrackGenerator adaptive(&path, 1.2f, 0.2f, SAMPLES, tessellation);
+            BenchClock::time_point start = BenchClock::now();
+            std::vector<float> knots = adaptive.getRailKnots();
+            double knotMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+            int segments = (int)knots.size() - 1;
+            float deviation = measureRailDeviation(path, adaptive, knots);
+
+            // najmanja ravnomerna podela sa odstupanjem do istog (izmerenog) odstupanja, binarnom pretragom
+            int low = 1, high = SAMPLES * 2;
+            while (low < high) {
+                int middle = (low + high) / 2;
+                TrackGenerator candidate(&path, 1.2f, 0.2f, middle);
+                if (measureRailDeviation(path, candidate, candidate.getRailKnots()) <= deviation)
+                    high = middle;
+                else
+                    low = middle + 1;
+            }
+            double reduction = 1.0 - double(segments) / low;
+            reduced = reduced && segments <= low;
+            std::cout << "  tolerancija " << tolerance * 1000.0f << " mm: " << segments * VERTICES_PER_SEGMENT
+                << " verteksa (" << segments << " kvadara, cvorovi za " << knotMs << " ms), odstupanje " << deviation * 1000.0f
+                << " mm; ravnomerno za isto odstupanje " << low * VERTICES_PER_SEGMENT << " verteksa -> "
+                << reduction * 100.0 << "% manje\n";
+        }
+    }
+    return reduced ? 0 : 1;
+}
+
+int runSweepBench() {
+    Path path(40.0f, 3.0f, 1.0f, 4.0f, 3, glm::vec3(-20, 0, 0));
+    const int SAMPLES = 5000;
+    // stari kvadar po segmentu: 6 strana po 4 verteksa i 2 trougla, za svaku sinu
+    const size_t BOX_VERTICES = 24, BOX_INDICES = 36;
+
+    struct NamedProfile { const char* name; SweepProfile profile; };
+    NamedProfile profiles[] = {
+        { "kvadar", SweepProfile::box(0.12f, 0.1f) },
+        { "I profil", SweepProfile::iBeam(0.12f, 0.1f, 0.03f, 0.015f) },
+        { "cev (12)", SweepProfile::tube(0.1f, 12) },
+    };
+
+    bool fewer = true;
+    for (float tolerance : { 0.0f, 0.001f }) {
+        TrackTessellation tessellation;
+        tessellation.tolerance = tolerance;
+        TrackGenerator generator(&path, 1.2f, 0.2f, SAMPLES, tessellation);
+        size_t rings = generator.getRailKnots().size();
+        size_t segments = rings - 1;
+        size_t oldVertices = segments * 2 * BOX_VERTICES, oldIndices = segments * 2 * BOX_INDICES;
+
+        BenchClock::time_point start = BenchClock::now();
+        TrackPart rails;
+        generator.generateRails(rails);
+        double railMs = elapsedMicroseconds(start, BenchClock::now()) / 1000.0;
+
+        std::cout << (tolerance > 0.0f ? "adaptivno 1 mm" : "ravnomerno") << ", " << segments << " segmenata po sini:\n"
+            << "  nezavisni kvadri: " << oldVertices << " verteksa, " << oldIndices << " indeksa\n";
+        for (const NamedProfile& named : profiles) {
+            SweepBuilder builder(named.profile);
+            size_t vertices = 2 * builder.getVertexCount(rings, true);
+            size_t indices = 2 * builder.getIndexCount(rings, true);
+            std::cout << "  izvlacenje, " << named.name << ": " << vertices << " verteksa (" << double(oldVertices) / vertices
+                << "x manje), " << indices << " indeksa\n";
+        }
+        // isti presek (kvadar) mora imati bar dvostruko manje verteksa
+        SweepBuilder box(profiles[0].profile);
+        fewer = fewer && 2 * box.getVertexCount(rings, true) * 2 < oldVertices;
+        std::cout << "  generateRails (dve sine): " << rails.vertices.size() << " verteksa, "
+            << rails.indices.size() << " indeksa, " << railMs << " ms\n";
+    }
+    return fewer ? 0 : 1;
+}
+
+int runGpuRailsCheck(const std::string& trackFile) {
+    const int SAMPLES = 5000;
+    const float TOLERANCE = 1e-5f;
+
+    std::vector<std::pair<std::string, PathParams>> tracks = builtInAndFileTracks(trackFile);
+
+    bool matches = true;
+    for (const auto& track : tracks) {
+        Path path(track.second);
+        for (float tolerance : { 0.0f, 0.001f }) {
+            TrackTessellation tessellation;
+            tessellation.tolerance = tolerance;
+            TrackGenerator generator(&path, 1.2f, 0.2f, SAMPLES, tessellation);
+
+            TrackPart rails;
+            generator.generateRails(rails);
+            std::vector<RailSample> samples;
+            generator.generateRailSamples(samples);
+            std::vector<RailTemplateVertex> segmentTemplate = GpuRails::buildTemplate(generator);
+            size_t segments = samples.size() - 1;
+
+            // u mesh-u su izvlacenja redom (leva pa desna sina), svako: segmenti pa poklopci;
+            // u sablonu je za jedan segment isti redosled izvlacenja i strana
+            SweepBuilder rail(generator.getRailProfile());
+            size_t indexBase = 0, templateBase = 0, covered = 0;
+            float positionError = 0.0f, normalError = 0.0f, uvError = 0.0f;
+            for (int sweep = 0; sweep < 2; sweep++) {
+                size_t segmentIndices = rail.getIndexCount(2, false);
+                for (size_t segment = 0; segment < segments; segment++) {
+                    for (size_t i = 0; i < segmentIndices; i++) {
+                        const Vertex& cpu = rails.vertices[rails.indices[indexBase + segment * segmentIndices + i]];
+                        Vertex gpu = GpuRails::expand(segmentTemplate[templateBase + i], samples.data(), segment,
+                            generator.getRailOffset());
+                        positionError = std::max(positionError, glm::length(gpu.Position - cpu.Position));
+                        normalError = std::max(normalError, glm::length(gpu.Normal - cpu.Normal));
+                        uvError = std::max(uvError, glm::length(gpu.TexCoords - cpu.TexCoords));
+                    }
+                }
+                covered += segments * segmentIndices;
+                indexBase += rail.getIndexCount(segments + 1, true);
+                templateBase += segmentIndices;
+            }
+            // poklopci se na GPU ne crtaju: na zatvorenoj stazi su krajevi na istom mestu
+            float endGap = glm::length(path.getFrame(1.0f).position - path.getFrame(0.0f).position);
+
+            size_t meshBytes = rails.vertices.size() * sizeof(Vertex) + rails.indices.size() * sizeof(unsigned int);
+            size_t gpuBytes = samples.size() * sizeof(RailSample) + segmentTemplate.size() * sizeof(RailTemplateVertex);
+            bool ok = covered == segments * segmentTemplate.size() && templateBase == segmentTemplate.size() &&
+                positionError <= TOLERANCE && normalError <= TOLERANCE && uvError <= TOLERANCE;
+            matches = matches && ok;
+            std::cout << track.first << ", " << (tolerance > 0.0f ? "adaptivno 1 mm" : "ravnomerno") << ": "
+                << segments << " segmenata, sablon " << segmentTemplate.size() << " verteksa\n"
+                << "  mesh sina " << rails.vertices.size() << " verteksa, " << meshBytes / 1024 << " KB; GPU okviri i sablon "
+                << gpuBytes / 1024 << " KB (" << double(meshBytes) / gpuBytes << "x manje)\n"
+                << "  najvece razlike: pozicija " << positionError << " m, normala " << normalError << ", uv " << uvError
+                << ", razmak krajeva " << endGap << " m -> " << (ok ? "isto" : "RAZLIKUJE SE") << "\n";
+        }
+    }
+    return matches ? 0 : 1;
+}
+
+// svi programi (sve permutacije) su linkovani; greske kompajliranja i linkovanja je vec ispisao Shader
+static bool allVariantsLinked(ShaderPermutations& shaders, unsigned int variants, const char* name) {
+    bool linked = true;
+    for (unsigned int mask = 0; mask < variants; mask++) {
+        GLint status = GL_FALSE;
+        glGetProgramiv(shaders.get(mask).ID, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            std::cout << "  " << name << ", permutacija " << mask << ": program nije linkovan\n";
+            linked = false;
+        }
+    }
+    return linked;
+}
+
+int runGpuRailsRenderCheck(const std::string& trackFile) {
+    const int SAMPLES = 5000;
+    const int WIDTH = 640, HEIGHT = 480;
+    const int CHANNEL_TOLERANCE = 2;            // razlika kanala (0-255) koja se ne broji (zaokruzivanje)
+    const double MAX_DIFFERENT = 0.002;         // deo pokrivenih piksela koji sme da se razlikuje (ivice trouglova)
+
+    std::cout << "GL: " << glGetString(GL_RENDERER) << ", " << glGetString(GL_VERSION) << "\n";
+
+    // 1) rail_gpu.vert i basic.vert sa basic.frag, sve permutacije kao u prozorskom modu
+    const std::vector<std::string> features = { "APPLY_GREEN", "GREEN_FILTER" };
+    unsigned int variants = 1u << features.size();
+    ShaderPermutations basicShaders("basic.vert", "basic.frag", features);
+    ShaderPermutations railShaders("rail_gpu.vert", "basic.frag", features);
+    bool basicLinked = allVariantsLinked(basicShaders, variants, "basic.vert + basic.frag");
+    bool railLinked = allVariantsLinked(railShaders, variants, "rail_gpu.vert + basic.frag");
+    std::cout << "sejderi: " << (basicLinked && railLinked ? "linkovano" : "NISU LINKOVANI") << " (" << 2 * variants << " programa)\n";
+    if (!basicLinked || !railLinked)
+        return 1;
+    basicShaders.forEach([](Shader& shader) { CommandReplayer::bindObjectBlock(shader); });
+
+    // 2) framebuffer van ekrana i tekstura sa poljima (pogresan uv se odmah vidi)
+    GLuint fbo, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, WIDTH, HEIGHT);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    const int CHECKER_SIZE = 64, CHECKER_CELL = 8;
+    std::vector<unsigned char> checker(CHECKER_SIZE * CHECKER_SIZE * 4, 255);
+    for (int y = 0; y < CHECKER_SIZE; y++)
+        for (int x = 0; x < CHECKER_SIZE; x++) {
+            bool light = (x / CHECKER_CELL + y / CHECKER_CELL) % 2 == 0;
+            unsigned char* texel = &checker[(y * CHECKER_SIZE + x) * 4];
+            texel[0] = light ? 230 : 40;
+            texel[1] = light ? 200 : 60;
+            texel[2] = (unsigned char)(x * 4);
+        }
+    GLuint checkerTexture;
+    glGenTextures(1, &checkerTexture);
+    glBindTexture(GL_TEXTURE_2D, checkerTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, CHECKER_SIZE, CHECKER_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, checker.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glViewport(0, 0, WIDTH, HEIGHT);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glDisable(GL_BLEND);
+
+    // 3) mesh sina preko CommandReplayer-a i GpuRails iz nekoliko pogleda, pa poredjenje piksela;
+    // pozadina ima alfa 0, pa je pokriven svaki piksel sa alfom vecom od 0
+    CommandReplayer replayer;
+    std::vector<unsigned char> cpuPixels(WIDTH * HEIGHT * 4), gpuPixels(WIDTH * HEIGHT * 4);
+    auto render = [&](const std::function<void()>& draw, std::vector<unsigned char>& pixels) {
+        glClearColor(0.2f, 0.3f, 0.5f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        draw();
+        glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    };
+
+    bool matches = complete;
+    if (!complete)
+        std::cout << "framebuffer nije kompletan\n";
+    for (const auto& track : builtInAndFileTracks(trackFile)) {
+        if (!complete)
+            break;
+        Path path(track.second);
+        for (float tolerance : { 0.0f, 0.001f }) {
+            TrackTessellation tessellation;
+            tessellation.tolerance = tolerance;
+            TrackGenerator generator(&path, 1.2f, 0.2f, SAMPLES, tessellation);
+            TrackPart rails;
+            generator.generateRails(rails);
+            std::vector<RailSample> samples;
+            generator.generateRailSamples(samples);
+
+            Mesh railMesh(rails.vertices, rails.indices, { { checkerTexture, "uDiffMap", "" } });
+            CommandBuffer commands;
+            commands.draw(basicShaders.get(0), railMesh, commands.addObject(glm::mat4(1.0f)));
+            replayer.upload({ &commands });
+            GpuRails gpuRails;
+            gpuRails.setup(generator, checkerTexture);
+            gpuRails.uploadSamples(samples);
+
+            // pogledi: cela staza, sina izbliza i niz stazu preko spoja kraja i pocetka (tamo mesh ima poklopce)
+            glm::vec3 low(FLT_MAX), high(-FLT_MAX);
+            for (const RailSample& sample : samples) {
+                low = glm::min(low, glm::vec3(sample.position));
+                high = glm::max(high, glm::vec3(sample.position));
+            }
+            glm::vec3 center = (low + high) * 0.5f;
+            float extent = glm::length(high - low);
+            PathFrame closeUp = path.getFrame(0.3f), seam = path.getFrame(0.0f);
+            struct View { const char* name; glm::vec3 eye, target; };
+            View views[] = {
+                { "cela staza", center + glm::vec3(0.0f, 0.6f * extent, 0.8f * extent), center },
+                { "izbliza", closeUp.position + closeUp.normal * 1.5f + closeUp.binormal * 0.8f, closeUp.position },
+                { "spoj", seam.position - seam.tangent * 3.0f + seam.binormal * 0.6f, seam.position + seam.tangent },
+            };
+
+            std::cout << track.first << ", " << (tolerance > 0.0f ? "adaptivno 1 mm" : "ravnomerno") << ":\n";
+            for (const View& view : views) {
+                glm::mat4 viewMatrix = glm::lookAt(view.eye, view.target, glm::vec3(0.0f, 1.0f, 0.0f));
+                glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)WIDTH / HEIGHT, 0.1f, 4.0f * extent);
+                auto setSceneUniforms = [&](Shader& shader) {
+                    shader.setVec3("uLightPos", -20, 3, -20);
+                    shader.setVec3("uViewPos", 0, 0, 5);
+                    shader.setVec3("uLightColor", 1, 1, 1);
+                    shader.setInt("uDiffMap1", 0);
+                    shader.setMat4("uV", viewMatrix);
+                    shader.setMat4("uP", projection);
+                };
+                basicShaders.forEach(setSceneUniforms);
+                railShaders.forEach(setSceneUniforms);
+
+                render([&]() { replayer.replay(commands); }, cpuPixels);
+                render([&]() { gpuRails.draw(railShaders.get(0)); }, gpuPixels);
+
+                size_t covered = 0, different = 0;
+                int maxDifference = 0;
+                for (size_t i = 0; i < cpuPixels.size(); i += 4) {
+                    if (cpuPixels[i + 3] == 0 && gpuPixels[i + 3] == 0)
+                        continue;
+                    covered++;
+                    int difference = 0;
+                    for (int channel = 0; channel < 4; channel++)
+                        difference = std::max(difference, std::abs(cpuPixels[i + channel] - gpuPixels[i + channel]));
+                    maxDifference = std::max(maxDifference, difference);
+                    if (difference > CHANNEL_TOLERANCE)
+                        different++;
+                }
+                double fraction = covered > 0 ? double(different) / covered : 1.0;
+                bool ok = covered > 0 && fraction <= MAX_DIFFERENT;
+                matches = matches && ok;
+                std::cout << "  " << view.name << ": pokriveno " << covered << " piksela, razlikuje se " << different
+                    << " (" << 100.0 * fraction << "%), najveca razlika kanala " << maxDifference
+                    << (ok ? "" : " - RAZLIKUJE SE") << "\n";
+            }
+            railMesh.release();
+            gpuRails.release();
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteTextures(1, &checkerTexture);
+    return matches ? 0 : 1;
+}
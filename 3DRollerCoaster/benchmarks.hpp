@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+
+// dijagnosticki i benchmark modovi koji se pokrecu iz komandne linije (bez prozora)
+// vracaju 0 ako je sve proslo kako treba
+
+// pisac i citalac trostrukog bafera rade punom brzinom "seconds" sekundi;
+// proverava se da citalac nikad ne vidi polovicno upisan snapshot i da nijedna strana ne ceka: objavljivanje ili
+// citanje duze od 100 us sme da bude najvise 0.1% operacija (samo prekidi niti od strane OS-a)
+int runTripleBufferStress(double seconds);
+
+// headless simulacija: Path, CartMotion, RideController i putnici bez prozora i bez geometrije;
+// "rides" voznji se odvozi u fast-forward-u (ukrcavanje, vezivanje, voznja, ponekad mucnina, iskrcavanje)
+int runHeadlessRides(int rides);
+
+// generisanje geometrije staze za 5000, 50000 i 500000 uzoraka: redom i sa job sistemom za 2, 4, ... niti
+// (do broja jezgara); proverava da je rezultat paralelnog generisanja identican
+int runTrackGenerationBench();
+
+// analiticki izvodi putanje: poredjenje sa konacnim razlikama (tangenta i krivina po celoj putanji,
+// tangenta na samom kraju) i brzina getTangent u odnosu na staru tangentu preko dve tacke
+int runPathDerivativeCheck();
+
+// propusnost pojedinacnih (getPoint/getTangent/getFrame) i grupnih (getPoints/getTangents/getFrames) poziva
+// nad istim nizom t-ova; proverava se i da se rezultati razlikuju samo u greski SIMD sin/cos
+int runPathBatchBench();
+
+// staza iz fajla (Catmull-Rom kroz kontrolne tacke): izvodi prema konacnim razlikama, neprekidnost tangente
+// na spojevima i poklapanje poze na kraju sa pocetkom; zatim cena getPoint/getPose/getPointAtDistance
+// za sintetisane staze sa sve vise tacaka (treba da ostane ista, lookup je konstantnog vremena)
+int runSplinePathCheck(const std::string& trackFile);
+
+// pecena staza: ~10 km staza se napravi (putanja + geometrija), upise u fajl pa ucita mapiranjem;
+// poredi vreme sa obicnim citanjem istog fajla, proverava da je ucitano isto i da se osteceni fajl odbacuje
+int runTrackBundleBench();
+
+// adaptivna podela sina: za nekoliko tolerancija broj verteksa sina i izmereno najvece odstupanje od stvarne sine,
+// u poredjenju sa ravnomernom podelom koja ima isto najvece odstupanje (ugradjena staza i staza iz fajla)
+int runTrackTessellationBench(const std::string& trackFile);
+
+// sine kao izvlacenje preseka sa zajednickim prstenovima: broj verteksa i indeksa u odnosu na
+// nezavisne kvadre po segmentu (ravnomerno i adaptivno), za kvadar, I profil i cev, i vreme generisanja sina
+int runSweepBench();
+
+// sine izvucene u rail_gpu.vert: isti racun na CPU (GpuRails::expand) za svaki verteks svake instance se poredi sa
+// trouglovima iz generateRails (ugradjena staza i staza iz fajla), i velicina okvira na GPU prema mesh-u sina
+int runGpuRailsCheck(const std::string& trackFile);
+
+// jedini mod kome treba GL kontekst (main ga pravi u skrivenom prozoru): rail_gpu.vert i basic.vert sa basic.frag
+// se kompajliraju i linkuju u svim permutacijama, pa se mesh sina (CommandReplayer) i GpuRails crtaju van ekrana
+// iz nekoliko pogleda i porede piksel po piksel
+int runGpuRailsRenderCheck(const std::string& trackFile);
@@ -1,5 +1,7 @@
 #include "cart.hpp"
 #include "humanoid_model.hpp"
+#include <algorithm>
+#include <cmath>
 
 Cart::Cart(
     Path* path,
@@ -9,10 +11,7 @@ Cart::Cart(
     float wallThickness,
     unsigned int texID,
     unsigned int woodTexID,
-    unsigned int plasticTexID,
-    std::vector<HumanoidModel>& seatedHumanoids,
-    RideController* rideController
-) : Model(""),
+    unsigned int plasticTexID) : Model(""),
 path(path),
 width(width),
 height(height),
@@ -21,8 +20,6 @@ wall(wallThickness),
 texID(texID),
 woodTexID(woodTexID),
 plasticTexID(plasticTexID),
-seatedHumanoids(seatedHumanoids),
-rideController(rideController),
 seatSize(                       // dimenzije sedista u odnosu na cart
     glm::vec3 (
     width * 0.15f,
@@ -41,14 +38,30 @@ cushionSize(                    // dimenizije cushion-a u odnosu na sedista
     generateCart();
     generateSeats();
     generateCushions();
+    calculatePartBounds();
 }
 
-glm::mat4 Cart::getModelMatrix() {
-    return modelMatrix;
+void Cart::calculatePartBounds() {
+    for (int part = 0; part < 3 && part < (int)meshes.size(); part++) {
+        partMin[part] = glm::vec3(FLT_MAX);
+        partMax[part] = glm::vec3(-FLT_MAX);
+        for (const Vertex& v : meshes[part].vertices) {
+            partMin[part] = glm::min(partMin[part], v.Position);
+            partMax[part] = glm::max(partMax[part], v.Position);
+        }
+    }
+}
+
+const Mesh& Cart::getPart(Part part) const {
+    return meshes[part];
 }
 
-void Cart::setDeltaTime(float dt) {
-    deltaTime = dt;
+glm::vec3 Cart::getPartMin(Part part) const {
+    return partMin[part];
+}
+
+glm::vec3 Cart::getPartMax(Part part) const {
+    return partMax[part];
 }
 
 void Cart::generateCart()
@@ -84,12 +97,6 @@ void Cart::generateCart()
                   base, base + 1, base + 2 });
         };
 
-    float t = 0.0f;
-    glm::vec3 p = path->getPoint(t);
-    glm::vec3 T = path->getTangent(t);
-    glm::vec3 N = glm::normalize(glm::cross(glm::vec3(0, 1, 0), T));
-    glm::vec3 B = glm::normalize(glm::cross(T, N));
-
     // ================= SPOLJA =================
     addQuad(
         { -hw, -hh, hd },
@@ -354,120 +361,28 @@ void Cart::generateCushions()
     meshes.push_back(Mesh(vertices, indices, textures));
 }
 
-void Cart::update()
+void Cart::setPath(Path* newPath)
 {
-    if (!path) return;
-
-    if (rideController->getRideState() != RideState::ACTIVE &&
-        rideController->getRideState() != RideState::SOMEONE_SICK &&
-        !isReturning && !isStopped && !isStopping)
-    {
-        t = 0.0f;
-    }
-    else {
-        // update kad je normalna voznja
-        if (rideController->getRideState() == RideState::ACTIVE &&
-            !isStopping && !isStopped && !isReturning) {
-            glm::vec3 p = path->getPoint(t);
-            glm::vec3 nextP = path->getPoint(std::min(t + 0.001f, 1.0f));   // mali korak za nagib
-            float dy = nextP.y - p.y;                                       // razlika visine
-
-            if (dy > 0.0f) {                        // uzbrdo
-                speed /= DECELERATION;              // usporava
-                if (speed <= ACCELERATION * 2.f)    // da ne bude presporo
-                    speed = ACCELERATION * 2.f;
-            }
-            if (dy < 0.0f) {
-                speed += ACCELERATION;
-            }
-            if (dy == 0.0f) {
-                speed += ACCELERATION;
-                if (speed >= TOP_SPEED)             // na ravnom postoji granica za ubrzanje
-                    speed = TOP_SPEED;
-            }
-
-            // update po transliranoj koordinati kola
-            t += speed;
-            if (t > 1.0f) {
-                t = 1.0f;
-                rideController->rideEnded();
-                speed = 0.0f;
-            }
-        }
-        if (rideController->getRideState() == RideState::SOMEONE_SICK &&
-            !isStopping && !isStopped && !isReturning)
-        {
-            isStopping = true;
-        }
-        if (isStopping && !isStopped) {
-            speed *= STOPPING_DECELERATION; // usporava
-            t += speed;
-            if (speed <= 0.000000001f) {    // kad speed postane dovoljno malo kola stanu
-                speed = 0.0f;
-                isStopped = true;
-                stopTimer = 0.0f;
-            }
-        }
-        if (isStopped) {
-            stopTimer += deltaTime;
-
-            if (stopTimer >= 10.0f) {
-                isStopped = false;
-                isStopping = false;
-                isReturning = true;
-                speed = RETURN_SPEED;
-            }
-        }
-        if (isReturning) {
-            if (t < 0.5) {
-                t -= speed;
-
-                if (t <= 0.0f) {
-                    t = 0.0f;
-                    isReturning = false;
-                    rideController->rideEnded();
-                }
-            }
-            if (t >= 0.5) {
-                t += speed;
-
-                if (t >= 1.0f) {
-                    t = 1.0f;
-                    isReturning = false;
-                    rideController->rideEnded();
-                }
-            }
-        }
-    }
-
-    glm::vec3 p = path->getPoint(t);
-    glm::vec3 T = glm::normalize(path->getTangent(t));
-
-    glm::vec3 worldUp(0,1,0);
-    glm::vec3 N = glm::normalize(glm::cross(worldUp, T));
-    glm::vec3 B = glm::normalize(glm::cross(T, N));
+    path = newPath;
+}
 
-    // kreiramo 4x4 matricu iz kolona (X=N, Y=B, Z=T)
-    glm::mat4 rot;
-    rot[0] = glm::vec4(N, 0.0f);
-    rot[1] = glm::vec4(B, 0.0f);
-    rot[2] = glm::vec4(T, 0.0f);
-    rot[3] = glm::vec4(0, 0, 0, 1);
+glm::mat4 Cart::computeModelMatrix(float t) const
+{
+    // poza iz tabele okvira putanje: kolone rotacije su (X=N, Y=B, Z=T)
+    PathPose pose = path->getPose(t);
+    glm::vec3 p = pose.position;
+    glm::mat4 rot = glm::mat4_cast(pose.orientation);
 
     // translacija
     float yCartOffset = height * 1.25;//3.15;
     p.y += yCartOffset;
     glm::mat4 trans = glm::translate(glm::mat4(1.0f), p);
 
-    // update-ujemo model matricu: translacija prvo, pa rotacija
-    modelMatrix = trans*rot;
-
-    updateHumanoids();
+    // translacija prvo, pa rotacija
+    return trans*rot;
 }
 
-void Cart::updateHumanoids() {
-    if (seatedHumanoids.empty()) return;
-
+glm::mat4 Cart::computeHumanoidMatrix(const HumanoidModel& humanoid, const glm::mat4& cartMatrix) const {
     // Pretpostavimo da imamo 4x2 raspored sedista (4 reda x 2 kolone)
     int rows = 4;
     int cols = 2;
@@ -477,45 +392,40 @@ void Cart::updateHumanoids() {
     float seatY = -height + seatSize.y * 1.2f + (seatSize.y + cushionSize.y * 0.9f) * 1.1f;// +cushionSize.y; // visina sedista u lokalnom prostoru cart-a
     float desiredHumanoidHeight = height * 4.f;
 
-    for (HumanoidModel& humanoid : seatedHumanoids) {
-        int seatIndex = humanoid.seatIndex;
+    int seatIndex = humanoid.seatIndex;
 
-        int row = seatIndex / cols;   // red sedista
-        int col = seatIndex % cols;   // kolona sedista
+    int row = seatIndex / cols;   // red sedista
+    int col = seatIndex % cols;   // kolona sedista
 
-        // flip red po Z-osi
-        /*
-        * ovo radimo da indeksi sedista ne bi bili:
-        * 1 3 5 7
-        * 0 2 4 6
-        * 
-        * vec:
-        * 7 5 3 1
-        * 6 4 2 0
-        */
-        row = (rows - 1) - row;
+    // flip red po Z-osi
+    /*
+    * ovo radimo da indeksi sedista ne bi bili:
+    * 1 3 5 7
+    * 0 2 4 6
+    * 
+    * vec:
+    * 7 5 3 1
+    * 6 4 2 0
+    */
+    row = (rows - 1) - row;
 
-        // lokalne koordinate sedista
-        float x = (col == 0 ? -1.f : 1.f) * spacingX * 0.5f;
-        float z = -depth * 0.6f + row * spacingZ;
+    // lokalne koordinate sedista
+    float x = (col == 0 ? -1.f : 1.f) * spacingX * 0.5f;
+    float z = -depth * 0.6f + row * spacingZ;
 
-        glm::vec3 seatPosLocal(x, seatY, z);
+    glm::vec3 seatPosLocal(x, seatY, z);
 
-        float scaleFactor = desiredHumanoidHeight / humanoid.model.getHeight();
-        glm::vec3 humanoidScale(scaleFactor);
+    float scaleFactor = desiredHumanoidHeight / humanoid.model.getHeight();
+    glm::vec3 humanoidScale(scaleFactor);
 
-        // sada kombinujemo sa transformacijom cart-a
-        glm::mat4 localTransform = glm::translate(glm::mat4(1.0f), seatPosLocal)
-                                    * glm::scale(glm::mat4(1.0f), humanoidScale);
-
-        // ovaj model treba dodatno rotirati
-        if (seatIndex == 6) {
-            localTransform = glm::rotate(localTransform, glm::radians(180.0f), glm::vec3(0, 1, 0));
-        }
+    // sada kombinujemo sa transformacijom cart-a
+    glm::mat4 localTransform = glm::translate(glm::mat4(1.0f), seatPosLocal)
+                                * glm::scale(glm::mat4(1.0f), humanoidScale);
 
-
-        // humanoid.modelMatrix je nova matica za crtanje
-        humanoid.modelMatrix = modelMatrix * localTransform;
+    // ovaj model treba dodatno rotirati
+    if (seatIndex == 6) {
+        localTransform = glm::rotate(localTransform, glm::radians(180.0f), glm::vec3(0, 1, 0));
     }
-}
 
+    return cartMatrix * localTransform;
+}
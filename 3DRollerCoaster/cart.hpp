@@ -2,7 +2,6 @@
 #include "model.hpp"
 #include "path.hpp"
 #include "humanoid_model.hpp"
-#include "ride_controller.hpp"
 #include <glm/glm.hpp>
 
 class Cart : public Model {
@@ -15,15 +14,21 @@ public:
         float wallThickness,
         unsigned int texID,
         unsigned int woodTexID,
-        unsigned int plasticTexID,
-        std::vector<HumanoidModel>& seatedHumanoids,
-        RideController* rideController
+        unsigned int plasticTexID
     );
 
-    glm::mat4 getModelMatrix();
+    // delovi kola koji se crtaju zasebno (sedista i cushion-i mogu da se odstrane occlusion culling-om)
+    enum Part { BODY = 0, SEATS = 1, CUSHIONS = 2 };
+    const Mesh& getPart(Part part) const;
+    glm::vec3 getPartMin(Part part) const;
+    glm::vec3 getPartMax(Part part) const;
 
-    void update();
-    void setDeltaTime(float dt);
+    // cisto racunanje poze (bez menjanja stanja) - kretanje kola je u CartMotion,
+    // a render nit pozu racuna nad snapshot-om simulacije
+    glm::mat4 computeModelMatrix(float t) const;
+    // putanja po kojoj se racuna poza (menja se kad se staza ponovo generise)
+    void setPath(Path* newPath);
+    glm::mat4 computeHumanoidMatrix(const HumanoidModel& humanoid, const glm::mat4& cartMatrix) const;
 private:
     // atributi kola
     Path* path;
@@ -34,31 +39,17 @@ private:
     unsigned int texID;
     unsigned int woodTexID;
     unsigned int plasticTexID;
-    std::vector<HumanoidModel>& seatedHumanoids;
-    RideController* rideController;
 
     // atributi sedista (u odnosu na atribute cart-a ce se izracunati)
     glm::vec3 seatSize;
     glm::vec3 cushionSize;
 
-    // pomocne promenljive i konstante za kretanje kola
-    float t = 0.0f;          // parametar po putanji 0 ... 1
-    float speed = 0.0f;      // koliko t ide po sekundi
-    const float TOP_SPEED = 0.0008f;    // maksimalna brzina ravnog dela
-    const float RETURN_SPEED = 0.0005f;
-    const float ACCELERATION = 0.000025f; // koliko kola ubrzavaju po update-u
-    const float DECELERATION = 1.04; // neki multiplier za usporenje da bi lepse izgledalo
-    const float STOPPING_DECELERATION = 0.85f;
-    float stopTimer = 0.0f;
-    float deltaTime = 0.0f;
-    bool isStopping = false;
-    bool isStopped = false;
-    bool isReturning = false;
-
-    glm::mat4 modelMatrix = glm::mat4(1.0f);
+    // granice svakog dela u lokalnom prostoru kola
+    glm::vec3 partMin[3];
+    glm::vec3 partMax[3];
 
     void generateCart();
     void generateSeats();
     void generateCushions();
-    void updateHumanoids();
+    void calculatePartBounds();
 };
@@ -0,0 +1,125 @@
+#include "cart_motion.hpp"
+#include <algorithm>
+#include <cmath>
+
+CartMotion::CartMotion(Path* path, RideController* rideController) :
+path(path),
+rideController(rideController)
+{
+}
+
+void CartMotion::setPath(Path* newPath) {
+    path.store(newPath, std::memory_order_release);
+}
+
+float CartMotion::getT() const {
+    return t;
+}
+
+float CartMotion::getPrevT() const {
+    return prevT;
+}
+
+void CartMotion::step()
+{
+    // putanja se cita jednom po koraku (render nit moze da je zameni izmedju dva koraka)
+    Path* path = this->path.load(std::memory_order_acquire);
+    if (!path) return;
+
+    // nova putanja: t se zadrzava, predjeni put se preracunava
+    if (path != currentPath) {
+        distance = path->getDistanceAtT(t);
+        currentPath = path;
+    }
+    float totalLength = path->getTotalLength();
+
+    prevT = t;
+
+    if (rideController->getRideState() != RideState::ACTIVE &&
+        rideController->getRideState() != RideState::SOMEONE_SICK &&
+        !isReturning && !isStopped && !isStopping)
+    {
+        distance = 0.0f;
+    }
+    else {
+        // update kad je normalna voznja
+        if (rideController->getRideState() == RideState::ACTIVE &&
+            !isStopping && !isStopped && !isReturning) {
+            glm::vec3 p = path->getPointAtDistance(distance);
+            glm::vec3 nextP = path->getPointAtDistance(distance + SLOPE_PROBE);   // mali korak za nagib
+            float dy = nextP.y - p.y;                                       // razlika visine
+
+            if (dy > 0.0f) {                        // uzbrdo
+                speed /= DECELERATION;              // usporava
+                if (speed <= MIN_CLIMB_SPEED)       // da ne bude presporo
+                    speed = MIN_CLIMB_SPEED;
+            }
+            if (dy < 0.0f) {
+                speed += ACCELERATION;
+            }
+            if (dy == 0.0f) {
+                speed += ACCELERATION;
+                if (speed >= TOP_SPEED)             // na ravnom postoji granica za ubrzanje
+                    speed = TOP_SPEED;
+            }
+
+            // update po predjenom putu
+            distance += speed;
+            if (distance > totalLength) {
+                distance = totalLength;
+                rideController->rideEnded();
+                speed = 0.0f;
+            }
+        }
+        if (rideController->getRideState() == RideState::SOMEONE_SICK &&
+            !isStopping && !isStopped && !isReturning)
+        {
+            isStopping = true;
+        }
+        if (isStopping && !isStopped) {
+            speed *= STOPPING_DECELERATION; // usporava
+            distance = std::min(distance + speed, totalLength);
+            if (speed <= STOP_SPEED) {      // kad speed postane dovoljno malo kola stanu
+                speed = 0.0f;
+                isStopped = true;
+                stopTimer = 0.0f;
+            }
+        }
+        if (isStopped) {
+            stopTimer += FIXED_DT;
+
+            if (stopTimer >= 10.0f) {
+                isStopped = false;
+                isStopping = false;
+                isReturning = true;
+                speed = RETURN_SPEED;
+            }
+        }
+        if (isReturning) {
+            // iz prve polovine putanje kola se vracaju unazad, iz druge idu napred do kraja
+            if (t < 0.5) {
+                distance -= speed;
+
+                if (distance <= 0.0f) {
+                    distance = 0.0f;
+                    isReturning = false;
+                    rideController->rideEnded();
+                }
+            }
+            else {
+                distance += speed;
+
+                if (distance >= totalLength) {
+                    distance = totalLength;
+                    isReturning = false;
+                    rideController->rideEnded();
+                }
+            }
+        }
+    }
+    t = path->getTAtDistance(distance);
+
+    // skok (npr. reset na pocetak staze) se ne interpolira
+    if (std::abs(t - prevT) > 0.5f)
+        prevT = t;
+}
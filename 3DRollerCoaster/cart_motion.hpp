@@ -0,0 +1,54 @@
+#pragma once
+#include "path.hpp"
+#include "ride_controller.hpp"
+#include <atomic>
+
+/*
+    kretanje kola po putanji (brzina, zaustavljanje i povratak)
+        - kola se krecu po predjenom putu u metrima (tabela duzine luka u Path), t se izvodi iz njega
+        - nema geometriju ni OpenGL pozive, pa moze da radi i bez prozora (headless)
+        - Cart samo racuna pozu za dati t (Cart::computeModelMatrix)
+*/
+class CartMotion {
+public:
+    CartMotion(Path* path, RideController* rideController);
+
+    // simulacija ide u fiksnim koracima (konstante kretanja su podesene za 75 koraka u sekundi),
+    // korake zadaje RideSimulation (ili headless petlja)
+    static constexpr float FIXED_DT = 1.0f / 75.0f;
+    static constexpr int MAX_STEPS_PER_FRAME = 64;
+
+    // jedan fiksni korak simulacije
+    void step();
+
+    // zamena putanje u toku rada (npr. posle ponovnog generisanja staze); t se zadrzava,
+    // a korak koji je vec u toku zavrsava sa starom putanjom
+    void setPath(Path* newPath);
+
+    float getT() const;
+    float getPrevT() const;
+
+private:
+    std::atomic<Path*> path;
+    Path* currentPath = nullptr;    // putanja nad kojom je izracunat distance (samo nit koja zove step)
+    RideController* rideController;
+
+    // pomocne promenljive i konstante za kretanje kola
+    float t = 0.0f;          // parametar po putanji 0 ... 1 (za crtanje)
+    float distance = 0.0f;   // predjeni put u metrima 0 ... getTotalLength()
+    float speed = 0.0f;      // koliko metara kola predju po koraku
+    // brzine su priblizno iste kao ranije na ravnom delu (tamo je 1 t oko 100 m)
+    const float TOP_SPEED = 0.08f;      // maksimalna brzina ravnog dela
+    const float RETURN_SPEED = 0.05f;
+    const float ACCELERATION = 0.0025f; // koliko kola ubrzavaju po update-u
+    const float MIN_CLIMB_SPEED = 0.012f; // najmanja brzina uzbrdo (da voznja traje kao ranije)
+    const float SLOPE_PROBE = 0.1f;     // na kom rastojanju napred se gleda nagib
+    const float STOP_SPEED = 0.0000001f; // ispod ove brzine kola stoje
+    const float DECELERATION = 1.04; // neki multiplier za usporenje da bi lepse izgledalo
+    const float STOPPING_DECELERATION = 0.85f;
+    float stopTimer = 0.0f;
+    float prevT = 0.0f;             // t u prethodnom koraku (za interpolaciju)
+    bool isStopping = false;
+    bool isStopped = false;
+    bool isReturning = false;
+};
@@ -0,0 +1,128 @@
+#include "command_buffer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+void CommandBuffer::clear() {
+    commands.clear();
+    objects.clear();
+}
+
+unsigned int CommandBuffer::addObject(const glm::mat4& model) {
+    objects.push_back(model);
+    return (unsigned int)objects.size() - 1;
+}
+
+void CommandBuffer::draw(const Shader& shader, const Mesh& mesh, unsigned int object) {
+    // mesh koji jos nije na GPU-u (npr. staza koja se tek upload-uje) ili je prazan (sine na GPU) se preskace
+    if (mesh.VAO == 0 || mesh.indexCount == 0)
+        return;
+
+    // basic.frag koristi samo uDiffMap1 (jedinica 0)
+    unsigned int texture = 0;
+    for (const Texture& tex : mesh.textures) {
+        if (tex.type == "uDiffMap") {
+            texture = tex.id;
+            break;
+        }
+    }
+
+    DrawCommand command;
+    command.program = shader.ID;
+    command.vao = mesh.VAO;
+    command.texture = texture;
+    command.indexCount = (unsigned int)mesh.indexCount;
+    command.object = object;
+    commands.push_back(command);
+}
+
+void CommandBuffer::draw(const Shader& shader, const Model& model, unsigned int object) {
+    for (const Mesh& mesh : model.meshes)
+        draw(shader, mesh, object);
+}
+
+CommandReplayer::CommandReplayer() {
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment < 1)
+        alignment = 1;
+    slotSize = (sizeof(glm::mat4) + alignment - 1) / alignment * alignment;
+    glGenBuffers(1, &ubo);
+}
+
+CommandReplayer::~CommandReplayer() {
+    glDeleteBuffers(1, &ubo);
+}
+
+void CommandReplayer::bindObjectBlock(const Shader& shader) {
+    GLuint blockIndex = glGetUniformBlockIndex(shader.ID, "Object");
+    if (blockIndex == GL_INVALID_INDEX) {
+        std::cout << "Program " << shader.ID << " nema uniform blok Object" << std::endl;
+        return;
+    }
+    glUniformBlockBinding(shader.ID, blockIndex, OBJECT_BINDING);
+}
+
+void CommandReplayer::upload(const std::vector<CommandBuffer*>& buffers) {
+    size_t slots = 0;
+    for (CommandBuffer* buffer : buffers) {
+        buffer->firstSlot = (unsigned int)slots;
+        slots += buffer->objects.size();
+    }
+
+    staging.resize(slots * slotSize);
+    for (CommandBuffer* buffer : buffers)
+        for (size_t i = 0; i < buffer->objects.size(); i++)
+            std::memcpy(&staging[(buffer->firstSlot + i) * slotSize], &buffer->objects[i], sizeof(glm::mat4));
+
+    // UBO se svaki frejm napuni iznova; glBufferData sa NULL (orphaning) da ne cekamo na GPU koji jos crta prethodni frejm
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    capacity = std::max(capacity, staging.size());
+    glBufferData(GL_UNIFORM_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+    if (!staging.empty())
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, staging.size(), staging.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    frames++;
+}
+
+void CommandReplayer::replay(const CommandBuffer& buffer) {
+    // stanje se prati samo unutar jednog buffer-a (izmedju njih se crta i drugim kodom)
+    unsigned int program = 0, vao = 0, texture = 0, slot = ~0u;
+
+    glActiveTexture(GL_TEXTURE0);
+    for (const DrawCommand& command : buffer.commands) {
+        if (command.program != program) {
+            glUseProgram(command.program);
+            program = command.program;
+            programBinds++;
+        }
+        if (command.vao != vao) {
+            glBindVertexArray(command.vao);
+            vao = command.vao;
+            vaoBinds++;
+        }
+        // mesh bez teksture koristi onu koja je vec vezana (kao Mesh::Draw)
+        if (command.texture != 0 && command.texture != texture) {
+            glBindTexture(GL_TEXTURE_2D, command.texture);
+            texture = command.texture;
+            textureBinds++;
+        }
+        unsigned int commandSlot = buffer.firstSlot + command.object;
+        if (commandSlot != slot) {
+            glBindBufferRange(GL_UNIFORM_BUFFER, OBJECT_BINDING, ubo, commandSlot * slotSize, sizeof(glm::mat4));
+            slot = commandSlot;
+        }
+        glDrawElements(GL_TRIANGLES, command.indexCount, GL_UNSIGNED_INT, 0);
+        draws++;
+    }
+    glBindVertexArray(0);
+}
+
+void CommandReplayer::printStats() const {
+    if (frames == 0)
+        return;
+    std::cout << "Komande po frejmu: crtanja " << (double)draws / frames
+        << ", promena programa " << (double)programBinds / frames
+        << ", VAO " << (double)vaoBinds / frames
+        << ", tekstura " << (double)textureBinds / frames << std::endl;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "shader.hpp"
+#include "mesh.hpp"
+#include "model.hpp"
+
+/*
+    snimanje komandi za crtanje van GL niti:
+        - CommandBuffer je obican CPU niz komandi (program, VAO, tekstura, matrica objekta, broj indeksa),
+          pa ga moze puniti bilo koja nit; svaki posao (job) puni svoj buffer, nema deljenja izmedju niti
+        - matrica objekta (uM) nije uniforma nego uniform blok Object: sve matrice iz svih buffer-a se jednom
+          po frejmu salju u jedan UBO, a komanda pri crtanju samo pomera offset (glBindBufferRange)
+        - CommandReplayer na GL niti izvrsava buffer-e redom i preskace bind-ove koji se ne menjaju
+*/
+struct DrawCommand {
+    unsigned int program;
+    unsigned int vao;
+    unsigned int texture;       // prva difuzna tekstura (0: ostaje vezana prethodna)
+    unsigned int indexCount;
+    unsigned int object;        // indeks matrice u buffer-u
+};
+
+class CommandBuffer {
+public:
+    void clear();
+
+    // matrica za objekat koji se crta sledecim komandama, vraca njen indeks
+    unsigned int addObject(const glm::mat4& model);
+    void draw(const Shader& shader, const Mesh& mesh, unsigned int object);
+    void draw(const Shader& shader, const Model& model, unsigned int object);
+
+private:
+    friend class CommandReplayer;
+
+    std::vector<DrawCommand> commands;
+    std::vector<glm::mat4> objects;
+    unsigned int firstSlot = 0;     // gde su matrice ovog buffer-a u UBO-u (postavlja upload)
+};
+
+class CommandReplayer {
+public:
+    // binding point uniform bloka Object u basic.vert
+    static const unsigned int OBJECT_BINDING = 0;
+
+    CommandReplayer();
+    ~CommandReplayer();
+
+    // povezuje blok Object programa sa OBJECT_BINDING (jednom, posle pravljenja programa)
+    static void bindObjectBlock(const Shader& shader);
+
+    // salje matrice svih buffer-a u UBO (jednom po frejmu, pre replay-a)
+    void upload(const std::vector<CommandBuffer*>& buffers);
+    void replay(const CommandBuffer& buffer);
+
+    void printStats() const;
+
+private:
+    unsigned int ubo = 0;
+    size_t slotSize = 0;            // sizeof(mat4) poravnato na GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    size_t capacity = 0;            // velicina UBO-a u bajtovima
+    std::vector<char> staging;
+
+    long long frames = 0;
+    long long draws = 0;
+    long long programBinds = 0;
+    long long vaoBinds = 0;
+    long long textureBinds = 0;
+};
@@ -0,0 +1,141 @@
+#include "dynamic_resolution.hpp"
+#include <algorithm>
+#include <iostream>
+
+DynamicResolution::DynamicResolution(int width, int height, double targetFps, DynamicResolutionConfig config) :
+width(width),
+height(height),
+frameBudget(1.0 / targetFps),
+config(config),
+scale(config.maxScale)
+{
+    applyScale(config.maxScale);
+    createFramebuffer();
+    glGenQueries(QUERY_COUNT, timerQueries);
+}
+
+DynamicResolution::~DynamicResolution() {
+    glDeleteQueries(QUERY_COUNT, timerQueries);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &colorTexture);
+    glDeleteRenderbuffers(1, &depthBuffer);
+}
+
+void DynamicResolution::createFramebuffer() {
+    // framebuffer je uvek pune velicine, skaliranje se radi samo preko viewport-a (nema realokacije pri promeni skale)
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    fboComplete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!fboComplete)
+        std::cout << "Framebuffer za dinamicku rezoluciju nije kompletan, scena se crta direktno!\n";
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DynamicResolution::setEnabled(bool enabled) {
+    if (enabled && !fboComplete) {
+        std::cout << "Dinamicka rezolucija nije dostupna (framebuffer nije kompletan)\n";
+        enabled = false;
+    }
+    this->enabled = enabled;
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+}
+
+bool DynamicResolution::isEnabled() const {
+    return enabled;
+}
+
+float DynamicResolution::getScale() const {
+    return enabled ? scale : 1.0f;
+}
+
+void DynamicResolution::applyScale(float newScale) {
+    scale = std::clamp(newScale, config.minScale, config.maxScale);
+    scaledWidth = std::max(1, (int)(width * scale));
+    scaledHeight = std::max(1, (int)(height * scale));
+}
+
+void DynamicResolution::beginScene() {
+    // GPU vreme merimo i kad je mod iskljucen, da bi odluka pri ukljucivanju bila odmah tacna
+    if (!queryPending[queryIndex]) {
+        glBeginQuery(GL_TIME_ELAPSED, timerQueries[queryIndex]);
+    }
+
+    if (!enabled) return;
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, scaledWidth, scaledHeight);
+}
+
+void DynamicResolution::endScene() {
+    if (!queryPending[queryIndex]) {
+        glEndQuery(GL_TIME_ELAPSED);
+        queryPending[queryIndex] = true;
+    }
+    queryIndex = (queryIndex + 1) % QUERY_COUNT;
+
+    if (!enabled) return;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, scaledWidth, scaledHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+}
+
+void DynamicResolution::update(double cpuFrameTime) {
+    // citamo samo GPU tajmere ciji su rezultati vec stigli
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        if (!queryPending[i]) continue;
+        GLuint available = 0;
+        glGetQueryObjectuiv(timerQueries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(timerQueries[i], GL_QUERY_RESULT, &elapsed);
+        lastGpuTime = elapsed * 1e-9;
+        queryPending[i] = false;
+    }
+
+    if (!enabled) return;
+
+    double frameTime = std::max(cpuFrameTime, lastGpuTime);
+    if (frameTime > frameBudget * config.downscaleRatio) {
+        overBudgetFrames++;
+        underBudgetFrames = 0;
+    }
+    else if (frameTime < frameBudget * config.upscaleRatio) {
+        underBudgetFrames++;
+        overBudgetFrames = 0;
+    }
+    else {
+        overBudgetFrames = 0;
+        underBudgetFrames = 0;
+    }
+
+    float newScale = scale;
+    if (overBudgetFrames >= config.hysteresisFrames)
+        newScale = scale - config.scaleStep;
+    else if (underBudgetFrames >= config.hysteresisFrames)
+        newScale = scale + config.scaleStep;
+
+    if (newScale != scale) {
+        float oldScale = scale;
+        applyScale(newScale);
+        overBudgetFrames = 0;
+        underBudgetFrames = 0;
+        if (scale != oldScale)
+            std::cout << "Dinamicka rezolucija: skala " << scale << " (" << scaledWidth << "x" << scaledHeight << ")\n";
+    }
+}
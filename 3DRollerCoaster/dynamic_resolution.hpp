@@ -0,0 +1,58 @@
+#pragma once
+#include <GL/glew.h>
+
+// podesavanja za dinamicku rezoluciju
+struct DynamicResolutionConfig {
+    float minScale = 0.5f;          // najmanja dozvoljena skala rezolucije scene
+    float maxScale = 1.0f;          // najveca dozvoljena skala (1.0 = nativna rezolucija)
+    float scaleStep = 0.05f;        // za koliko se skala menja odjednom
+    float downscaleRatio = 0.90f;   // ako frejm traje duze od ovog dela budzeta - smanjujemo skalu
+    float upscaleRatio = 0.70f;     // ako frejm traje krace od ovog dela budzeta - povecavamo skalu
+    int hysteresisFrames = 20;      // koliko frejmova zaredom uslov mora da vazi pre promene skale
+};
+
+/*
+    scena se crta u offscreen framebuffer cija se efektivna velicina (skala) prilagodjava
+    izmerenom vremenu frejma (max od CPU i GPU vremena) u odnosu na budzet 1 / TARGET_FPS,
+    pa se onda razvlaci na backbuffer; HUD (potpis) se crta posle toga u nativnoj rezoluciji
+*/
+class DynamicResolution {
+public:
+    DynamicResolution(int width, int height, double targetFps, DynamicResolutionConfig config = DynamicResolutionConfig());
+    ~DynamicResolution();
+
+    // ne ukljucuje se ako offscreen framebuffer nije kompletan (scena se tada crta direktno)
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    float getScale() const;
+
+    // preusmerava crtanje scene u offscreen framebuffer sa trenutnom skalom
+    void beginScene();
+    // razvlaci scenu na backbuffer i vraca viewport na nativnu rezoluciju
+    void endScene();
+    // prilagodjava skalu na osnovu CPU vremena frejma (u sekundama) i poslednjeg dostupnog GPU vremena
+    void update(double cpuFrameTime);
+
+private:
+    static const int QUERY_COUNT = 3;   // GPU tajmeri se citaju sa kasnjenjem da ne bismo cekali
+
+    int width, height;
+    double frameBudget;
+    DynamicResolutionConfig config;
+    bool enabled = false;
+    float scale;
+    int scaledWidth, scaledHeight;
+
+    int overBudgetFrames = 0;
+    int underBudgetFrames = 0;
+
+    GLuint fbo = 0, colorTexture = 0, depthBuffer = 0;
+    bool fboComplete = false;
+    GLuint timerQueries[QUERY_COUNT];
+    bool queryPending[QUERY_COUNT] = { false };
+    int queryIndex = 0;
+    double lastGpuTime = 0.0;
+
+    void createFramebuffer();
+    void applyScale(float newScale);
+};
@@ -0,0 +1,150 @@
+#include "frame_scheduler.hpp"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+// timeBeginPeriod / timeEndPeriod, za sve konfiguracije (Release nema winmm.lib u projektu)
+#pragma comment(lib, "winmm.lib")
+#endif
+
+FrameScheduler::FrameScheduler(double targetFps, FrameMode mode) :
+mode(mode),
+targetPeriod(1.0 / targetFps),
+refreshPeriod(1.0 / 60.0)
+{
+#ifdef _WIN32
+    timeBeginPeriod(1);
+#endif
+}
+
+FrameScheduler::~FrameScheduler() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+const char* frameModeName(FrameMode mode) {
+    switch (mode) {
+    case FrameMode::VSYNC: return "VSYNC";
+    case FrameMode::FIXED: return "FIXED";
+    case FrameMode::UNCAPPED: return "UNCAPPED";
+    }
+    return "?";
+}
+
+void FrameScheduler::setMode(FrameMode mode) {
+    this->mode = mode;
+    // swap interval vazi za trenutni kontekst, pa se ovo poziva sa render niti
+    glfwSwapInterval(mode == FrameMode::VSYNC ? 1 : 0);
+    firstFrame = true;
+    lastPacingError = 0.0;
+    totalAbsPacingError = 0.0;
+    maxPacingError = 0.0;
+    frameCount = 0;
+}
+
+FrameMode FrameScheduler::getMode() const {
+    return mode;
+}
+
+void FrameScheduler::setRefreshRate(double refreshRate) {
+    if (refreshRate > 0.0)
+        refreshPeriod = 1.0 / refreshRate;
+}
+
+void FrameScheduler::waitUntil(Clock::time_point deadline) {
+    // spavamo dok je do roka ostalo vise od praga, a ostatak "vrtimo"
+    while (true) {
+        Clock::time_point now = Clock::now();
+        double remaining = std::chrono::duration<double>(deadline - now).count();
+        if (remaining <= spinThreshold)
+            break;
+
+        double requested = remaining - spinThreshold;
+        std::this_thread::sleep_for(std::chrono::duration<double>(requested));
+        double slept = std::chrono::duration<double>(Clock::now() - now).count();
+
+        // ako sleep kasni vise od praga, prag raste (brzo), inace polako opada ka 0.5 ms
+        double oversleep = slept - requested;
+        if (oversleep > spinThreshold)
+            spinThreshold = std::min(oversleep * 1.25, 0.004);
+        else
+            spinThreshold = std::max(spinThreshold * 0.99, 0.0005);
+    }
+    while (Clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+void FrameScheduler::skipFrame() {
+    firstFrame = true;
+}
+
+double FrameScheduler::beginFrame() {
+    Clock::time_point now = Clock::now();
+    if (firstFrame) {
+        firstFrame = false;
+        lastFrameStart = now;
+        nextDeadline = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(targetPeriod));
+        return targetPeriod;
+    }
+
+    if (mode == FrameMode::FIXED) {
+        waitUntil(nextDeadline);
+        now = Clock::now();
+        recordPacingError(std::chrono::duration<double>(now - nextDeadline).count());
+
+        // rok se pomera za celu periodu od prethodnog roka, a ne od trenutka kad smo se probudili
+        nextDeadline += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(targetPeriod));
+        // ako smo zakasnili vise od cele periode (npr. ucitavanje), ne pokusavamo da "nadoknadimo" frejmove
+        if (now - nextDeadline > std::chrono::duration<double>(targetPeriod))
+            nextDeadline = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(targetPeriod));
+    }
+    else {
+        // swap sa vsync-om (ili bez ikakvog cekanja) vec odredjuje tempo, ovde ga samo merimo
+        double interval = std::chrono::duration<double>(now - lastFrameStart).count();
+        if (mode == FrameMode::VSYNC)
+            recordPacingError(interval - refreshPeriod);
+        else
+            recordPacingError(0.0);
+    }
+
+    double deltaTime = std::chrono::duration<double>(now - lastFrameStart).count();
+    lastFrameStart = now;
+    return deltaTime;
+}
+
+void FrameScheduler::recordPacingError(double error) {
+    lastPacingError = error * 1000.0;
+    totalAbsPacingError += std::fabs(lastPacingError);
+    maxPacingError = std::max(maxPacingError, std::fabs(lastPacingError));
+    frameCount++;
+}
+
+double FrameScheduler::getLastPacingError() const {
+    return lastPacingError;
+}
+
+double FrameScheduler::getAveragePacingError() const {
+    return frameCount > 0 ? totalAbsPacingError / frameCount : 0.0;
+}
+
+double FrameScheduler::getMaxPacingError() const {
+    return maxPacingError;
+}
+
+long long FrameScheduler::getFrameCount() const {
+    return frameCount;
+}
+
+void FrameScheduler::printStats() const {
+    std::cout << "Frame scheduler [" << frameModeName(mode) << "]: frejmova " << frameCount
+        << ", prosecna greska tempa " << getAveragePacingError() << " ms"
+        << ", najveca " << maxPacingError << " ms\n";
+}
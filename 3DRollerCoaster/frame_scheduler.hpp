@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+
+enum class FrameMode {
+    VSYNC,      // tempo diktira monitor (swap interval 1)
+    FIXED,      // fiksni TARGET_FPS, hibridno cekanje (sleep pa spin)
+    UNCAPPED    // bez ogranicenja, za benchmark
+};
+
+/*
+    raspored frejmova nad monotonim satom (steady_clock):
+        - u FIXED modu se rok za sledeci frejm pomera za tacno jednu periodu (nema akumulacije greske),
+          najveci deo cekanja se prespava, a poslednjih par milisekundi se "vrti" do roka
+        - prag za spin se prilagodjava tome koliko sleep_for na ovom sistemu zakasni; na Windows-u se za vreme
+          rada rezolucija tajmera spusta na 1 ms (inace je ~15.6 ms, vise nego sto spin pokriva)
+        - za svaki frejm se belezi greska u tempu (koliko je frejm poceo kasnije/ranije od plana)
+*/
+class FrameScheduler {
+public:
+    FrameScheduler(double targetFps, FrameMode mode = FrameMode::FIXED);
+    ~FrameScheduler();
+
+    void setMode(FrameMode mode);
+    FrameMode getMode() const;
+    // frekvencija monitora, koristi se kao ciljna perioda u VSYNC modu
+    void setRefreshRate(double refreshRate);
+
+    // ceka pocetak sledeceg frejma i vraca vreme proteklo od pocetka prethodnog (u sekundama)
+    double beginFrame();
+    // frejm nije nacrtan nego se cekalo na dogadjaj (RenderOnDemand): sledeci beginFrame pocinje tempo iz pocetka
+    // i ne ulazi u statistiku (cekanje nije greska u tempu)
+    void skipFrame();
+
+    // statistika greske u tempu (u milisekundama)
+    double getLastPacingError() const;
+    double getAveragePacingError() const;
+    double getMaxPacingError() const;
+    long long getFrameCount() const;
+    void printStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    FrameMode mode;
+    double targetPeriod;    // 1 / TARGET_FPS
+    double refreshPeriod;   // 1 / frekvencija monitora
+    Clock::time_point lastFrameStart;
+    Clock::time_point nextDeadline;
+    bool firstFrame = true;
+
+    double spinThreshold = 0.002;   // koliko pre roka prestajemo da spavamo (s)
+
+    double lastPacingError = 0.0;
+    double totalAbsPacingError = 0.0;
+    double maxPacingError = 0.0;
+    long long frameCount = 0;
+
+    void waitUntil(Clock::time_point deadline);
+    void recordPacingError(double error);
+};
+
+const char* frameModeName(FrameMode mode);
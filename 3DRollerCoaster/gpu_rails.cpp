@@ -0,0 +1,122 @@
+#include "gpu_rails.hpp"
+
+std::vector<RailTemplateVertex> GpuRails::buildTemplate(const TrackGenerator& generator)
+{
+    // redom leva pa desna sina (kao u generateRails); strana preseka je cetvorougao
+    // a0, b0, b1, a0, b1, a1 izmedju prstena 0 i 1, kao u SweepBuilder::writeSegments
+    SweepProfile profile = generator.getRailProfile();
+    std::vector<RailTemplateVertex> result;
+    for (float side : { -1.0f, 1.0f }) {
+        for (const glm::ivec2& edge : profile.edges) {
+            int corners[6][2] = { { edge.x, 0 }, { edge.y, 0 }, { edge.y, 1 }, { edge.x, 0 }, { edge.y, 1 }, { edge.x, 1 } };
+            for (const auto& corner : corners) {
+                int i = corner[0];
+                result.push_back({
+                    glm::vec4(profile.positions[i], profile.normals[i]),
+                    glm::vec4(profile.u[i], (float)corner[1], side, 0.0f)
+                });
+            }
+        }
+    }
+    return result;
+}
+
+Vertex GpuRails::expand(const RailTemplateVertex& vertex, const RailSample* samples, size_t segment,
+    float railOffset)
+{
+    const RailSample& sample = samples[segment + (size_t)vertex.params.y];
+    glm::vec3 position(sample.position);
+    glm::vec3 normal(sample.normal);
+    glm::vec3 binormal(sample.binormal);
+    glm::vec3 center = position + vertex.params.z * normal * railOffset;
+    return {
+        center + normal * vertex.profile.x + binormal * vertex.profile.y,
+        normal * vertex.profile.z + binormal * vertex.profile.w,
+        glm::vec2(vertex.params.x, sample.position.w)
+    };
+}
+
+void GpuRails::setup(const TrackGenerator& generator, unsigned int railTexID)
+{
+    this->railTexID = railTexID;
+    railOffset = generator.getRailOffset();
+
+    std::vector<RailTemplateVertex> vertices = buildTemplate(generator);
+    templateVertices = vertices.size();
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &templateVBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, templateVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(RailTemplateVertex), vertices.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(RailTemplateVertex), (void*)offsetof(RailTemplateVertex, profile));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(RailTemplateVertex), (void*)offsetof(RailTemplateVertex, params));
+    glBindVertexArray(0);
+
+    // okviri se citaju texelFetch-om iz texture buffer-a (RGBA32F, tri teksela po cvoru)
+    glGenBuffers(1, &sampleBuffer);
+    glGenTextures(1, &sampleTexture);
+}
+
+void GpuRails::uploadSamples(const std::vector<RailSample>& samples)
+{
+    sampleCount = samples.size();
+    glBindBuffer(GL_TEXTURE_BUFFER, sampleBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, samples.size() * sizeof(RailSample), samples.data(), GL_STATIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, sampleTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, sampleBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void GpuRails::release()
+{
+    if (VAO == 0)
+        return;
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &templateVBO);
+    glDeleteBuffers(1, &sampleBuffer);
+    glDeleteTextures(1, &sampleTexture);
+    VAO = templateVBO = sampleBuffer = sampleTexture = 0;
+    sampleCount = 0;
+}
+
+bool GpuRails::isReady() const
+{
+    return VAO != 0 && sampleCount >= 2;
+}
+
+void GpuRails::draw(const Shader& shader) const
+{
+    if (!isReady())
+        return;
+    shader.use();
+    shader.setInt("uSamples", SAMPLE_UNIT);
+    shader.setFloat("uRailOffset", railOffset);
+
+    glActiveTexture(GL_TEXTURE0 + SAMPLE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, sampleTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, railTexID);
+
+    glBindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, (GLsizei)templateVertices, (GLsizei)getSegmentCount());
+    glBindVertexArray(0);
+}
+
+size_t GpuRails::getSegmentCount() const
+{
+    return sampleCount > 0 ? sampleCount - 1 : 0;
+}
+
+size_t GpuRails::getSampleBytes() const
+{
+    return sampleCount * sizeof(RailSample);
+}
+
+size_t GpuRails::getTemplateVertexCount() const
+{
+    return templateVertices;
+}
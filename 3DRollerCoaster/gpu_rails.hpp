@@ -0,0 +1,54 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "mesh.hpp"
+#include "shader.hpp"
+#include "track_generator.hpp"
+
+// verteks sablona segmenta (rail_gpu.vert)
+struct RailTemplateVertex {
+    glm::vec4 profile;      // xy: tacka preseka, zw: normala u ravni preseka
+    glm::vec4 params;       // x: u, y: prsten (0 / 1), z: strana (-1 leva / 1 desna sina)
+};
+
+/*
+    sine izvucene u vertex sejderu umesto gotovog mesh-a:
+        - na GPU su samo okviri putanje u cvorovima sina (RailSample, texture buffer) i jedan sablon segmenta
+          sa stranama obe sine (par desetina verteksa)
+        - crta se jednim glDrawArraysInstanced, instanca je segment izmedju dva susedna cvora
+        - trouglovi su isti kao u generateRails (isti cvorovi, preseci i redosled temena), bez poklopaca
+          na krajevima (staza je zatvorena, pa se ionako ne vide)
+    mesh sina i njegova kopija u memoriji tada ne postoje (RollerCoaster ima prazan mesh na mestu sina)
+*/
+class GpuRails {
+public:
+    // sablon od preseka generatora; poziva se jednom, na GL niti
+    void setup(const TrackGenerator& generator, unsigned int railTexID);
+    // okviri cvorova (nova putanja zamenjuje staru)
+    void uploadSamples(const std::vector<RailSample>& samples);
+    void release();
+
+    bool isReady() const;
+    void draw(const Shader& shader) const;
+
+    size_t getSegmentCount() const;
+    size_t getSampleBytes() const;
+    size_t getTemplateVertexCount() const;
+
+    // sablon i racun iz rail_gpu.vert na CPU (provera poklapanja sa generateRails)
+    static std::vector<RailTemplateVertex> buildTemplate(const TrackGenerator& generator);
+    static Vertex expand(const RailTemplateVertex& vertex, const RailSample* samples, size_t segment,
+        float railOffset);
+
+    // jedinica teksture za uSamples (uDiffMap1 je na 0)
+    static const int SAMPLE_UNIT = 1;
+
+private:
+    unsigned int VAO = 0, templateVBO = 0;
+    unsigned int sampleBuffer = 0, sampleTexture = 0;
+    unsigned int railTexID = 0;
+    size_t templateVertices = 0;
+    size_t sampleCount = 0;
+    float railOffset = 0.0f;
+};
@@ -5,41 +5,18 @@
 #include <glm/glm.hpp>
 
 #include "model.hpp"
+#include "passenger.hpp"
 
-struct HumanoidModel {
+struct HumanoidModel : Passenger {
     Model model;
-    int seatIndex;
-    bool isActive;
-    bool isSick;
-    bool isBeltOn;
     float modelHeight;
     glm::mat4 modelMatrix;
 
-    HumanoidModel(const std::string& path, int seat)
-        : model(path), seatIndex(seat), isActive(false), isSick(false), isBeltOn(false), modelMatrix(1.0f) {
+    // uploadNow = false: ucitavanje na radnoj niti, model.uploadToGPU() kasnije na glavnoj
+    HumanoidModel(const std::string& path, int seat, bool uploadNow = true)
+        : Passenger(seat), model(path, false, uploadNow), modelMatrix(1.0f) {
         modelHeight = model.getHeight();
     }
-
-    void sitDown() {
-        isActive = true;
-    }
-
-    void leave() {
-        isActive = false;
-        isSick = false;
-    }
-
-    void putBeltOn() {
-        isBeltOn = true;
-    }
-
-    void putBeltOff() {
-        isBeltOn = false;
-    }
-
-    void becomeSick() {
-        isSick = true;
-    }
 };
 
 #endif
\ No newline at end of file
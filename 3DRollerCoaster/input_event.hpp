@@ -0,0 +1,52 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+enum class InputEventType : uint8_t {
+    KEY_PRESS,
+    MOUSE_MOVE
+};
+
+// dogadjaj sa ulaza (pravi se u GLFW callback-u, obradjuje se na tacno odredjenom mestu u koraku/frejmu)
+struct InputEvent {
+    InputEventType type = InputEventType::KEY_PRESS;
+    int key = 0;                // za KEY_PRESS
+    double x = 0.0, y = 0.0;    // za MOUSE_MOVE (pozicija kursora)
+    int64_t timestamp = 0;      // nanosekunde (steady_clock) kada je dogadjaj nastao
+};
+
+inline int64_t inputTimestampNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// propusnost i kasnjenje (od callback-a do obrade) za jedan red dogadjaja
+struct InputStats {
+    long long processed = 0;
+    long long dropped = 0;      // red je bio pun
+    int64_t totalLatency = 0;   // ns
+    int64_t maxLatency = 0;     // ns
+    int64_t firstTimestamp = 0;
+    int64_t lastTimestamp = 0;
+
+    void recordProcessed(const InputEvent& event, int64_t now) {
+        int64_t latency = now - event.timestamp;
+        if (processed == 0)
+            firstTimestamp = event.timestamp;
+        lastTimestamp = event.timestamp;
+        processed++;
+        totalLatency += latency;
+        maxLatency = std::max(maxLatency, latency);
+    }
+
+    void print(const char* name) const {
+        double averageMs = processed > 0 ? totalLatency / (double)processed * 1e-6 : 0.0;
+        double spanSeconds = (lastTimestamp - firstTimestamp) * 1e-9;
+        std::cout << "Ulaz [" << name << "]: obradjeno " << processed << ", odbaceno " << dropped
+            << ", prosecno kasnjenje " << averageMs << " ms, najvece " << maxLatency * 1e-6 << " ms";
+        if (spanSeconds > 0.0)
+            std::cout << ", " << processed / spanSeconds << " dogadjaja/s";
+        std::cout << std::endl;
+    }
+};
@@ -0,0 +1,228 @@
+#include "job_system.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+    // indeks radnika za tekucu nit (-1 za niti koje nisu radnici)
+    thread_local int currentWorker = -1;
+    // koliko poslova je trenutno ugnjezdeno na ovoj niti (posao koji ceka izvrsava druge poslove);
+    // vreme se meri samo za spoljasnji, da se ne bi racunalo dvaput
+    thread_local int executeDepth = 0;
+}
+
+JobSystem::JobSystem(int count) {
+    if (count <= 0)
+        count = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    workerCount = count;
+
+    for (int i = 0; i <= workerCount; i++)
+        workers.push_back(std::make_unique<Worker>());
+    statsStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < workerCount; i++)
+        workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running.store(false);
+    }
+    wakeUp.notify_all();
+    for (int i = 0; i < workerCount; i++)
+        workers[i]->thread.join();
+}
+
+int JobSystem::getWorkerCount() const {
+    return workerCount;
+}
+
+void JobSystem::submit(Job job, JobCounter* counter) {
+    if (counter)
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    int target = currentWorker >= 0 ? currentWorker : (int)(nextWorker.fetch_add(1, std::memory_order_relaxed) % workerCount);
+    {
+        std::lock_guard<std::mutex> lock(workers[target]->mutex);
+        workers[target]->jobs.push_back({ std::move(job), counter });
+    }
+    queuedJobs.fetch_add(1, std::memory_order_release);
+    {
+        // prazan lock: radnik koji bas proverava uslov za spavanje ne moze da propusti notify
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_one();
+}
+
+bool JobSystem::popOwn(int index, Entry& entry) {
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.jobs.empty())
+        return false;
+    entry = std::move(worker.jobs.back());
+    worker.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::steal(int thief, Entry& entry) {
+    // krene od suseda da se kradje ne gomilaju na prvom radniku
+    int start = thief >= 0 ? thief + 1 : 0;
+    for (int i = 0; i < workerCount; i++) {
+        int victim = (start + i) % workerCount;
+        if (victim == thief)
+            continue;
+        Worker& worker = *workers[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.jobs.empty())
+            continue;
+        entry = std::move(worker.jobs.front());
+        worker.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(Entry& entry, int statsSlot, bool stolen) {
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+    bool outermost = executeDepth == 0;
+    auto start = std::chrono::steady_clock::now();
+    executeDepth++;
+    entry.job();
+    executeDepth--;
+    long long busy = outermost ? std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() : 0;
+
+    Worker& stats = *workers[statsSlot];
+    stats.jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    if (stolen)
+        stats.jobsStolen.fetch_add(1, std::memory_order_relaxed);
+    stats.busyNanoseconds.fetch_add(busy, std::memory_order_relaxed);
+
+    if (entry.counter)
+        entry.counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+bool JobSystem::tryRunOne(int index) {
+    Entry entry;
+    int statsSlot = index >= 0 ? index : workerCount;
+    if (index >= 0 && popOwn(index, entry)) {
+        execute(entry, statsSlot, false);
+        return true;
+    }
+    if (steal(index, entry)) {
+        execute(entry, statsSlot, index >= 0);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(int index) {
+    currentWorker = index;
+    while (running.load()) {
+        if (tryRunOne(index))
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() { return !running.load() || queuedJobs.load(std::memory_order_acquire) > 0; });
+    }
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!tryRunOne(currentWorker))
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::parallelFor(int begin, int end, int grainSize, const std::function<void(int, int)>& body) {
+    if (end <= begin)
+        return;
+    grainSize = std::max(grainSize, 1);
+    if (end - begin <= grainSize) {
+        body(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    // poslednji komad radi pozivajuca nit odmah, ostale mogu da ukradu radnici
+    int last = begin + ((end - begin - 1) / grainSize) * grainSize;
+    for (int chunk = begin; chunk < last; chunk += grainSize) {
+        int chunkEnd = std::min(chunk + grainSize, end);
+        submit([&body, chunk, chunkEnd]() { body(chunk, chunkEnd); }, &counter);
+    }
+    body(last, end);
+    wait(counter);
+}
+
+JobSystem::WorkerStats JobSystem::getStats(int worker) const {
+    WorkerStats stats;
+    const Worker& w = *workers[worker];
+    stats.jobsExecuted = w.jobsExecuted.load();
+    stats.jobsStolen = w.jobsStolen.load();
+    stats.busySeconds = w.busyNanoseconds.load() * 1e-9;
+    return stats;
+}
+
+void JobSystem::resetStats() {
+    for (auto& worker : workers) {
+        worker->jobsExecuted.store(0);
+        worker->jobsStolen.store(0);
+        worker->busyNanoseconds.store(0);
+    }
+    statsStart = std::chrono::steady_clock::now();
+}
+
+void JobSystem::printStats() const {
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - statsStart).count();
+    std::cout << "Poslovi (" << workerCount << " radnika, " << elapsed << " s):\n";
+    for (int i = 0; i <= workerCount; i++) {
+        WorkerStats stats = getStats(i);
+        std::cout << "  " << (i < workerCount ? "radnik " + std::to_string(i) : std::string("ostale niti"))
+            << ": poslova " << stats.jobsExecuted << " (ukradeno " << stats.jobsStolen << "), zauzet "
+            << stats.busySeconds * 1000.0 << " ms (" << (elapsed > 0.0 ? stats.busySeconds / elapsed * 100.0 : 0.0) << "%)\n";
+    }
+}
+
+int JobGraph::add(JobSystem::Job job, const std::vector<int>& dependencies) {
+    int id = (int)nodes.size();
+    Node node;
+    node.job = std::move(job);
+    node.dependencyCount = 0;
+    nodes.push_back(std::move(node));
+    for (int dependency : dependencies) {
+        if (dependency < 0 || dependency >= id)
+            continue;   // zavisnost mora biti vec dodat posao (pa ciklus nije moguc)
+        nodes[dependency].dependents.push_back(id);
+        nodes[id].dependencyCount++;
+    }
+    return id;
+}
+
+int JobGraph::size() const {
+    return (int)nodes.size();
+}
+
+void JobGraph::run(JobSystem& jobSystem) {
+    if (nodes.empty())
+        return;
+
+    std::vector<std::atomic<int>> remaining(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+        remaining[i].store(nodes[i].dependencyCount);
+
+    JobCounter counter;
+    // posao posle svog izvrsavanja pokrece zavisne poslove kojima je to bila poslednja zavisnost;
+    // oni se dodaju pre nego sto se brojac za ovaj posao smanji, pa wait ne moze da izadje ranije
+    std::function<void(int)> schedule = [&](int id) {
+        jobSystem.submit([&, id]() {
+            nodes[id].job();
+            for (int dependent : nodes[id].dependents)
+                if (remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    schedule(dependent);
+        }, &counter);
+    };
+
+    for (size_t i = 0; i < nodes.size(); i++)
+        if (nodes[i].dependencyCount == 0)
+            schedule((int)i);
+    jobSystem.wait(counter);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// broj poslova koji jos nisu zavrseni (submit ga povecava, zavrsetak posla smanjuje)
+struct JobCounter {
+    std::atomic<int> pending{ 0 };
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+/*
+    thread pool sa kradjom poslova (work stealing):
+        - svaki radnik ima svoj red; svoje poslove uzima sa kraja (LIFO, topli kes),
+          a kad mu je red prazan krade sa pocetka tudjih redova (FIFO, veci komadi posla)
+        - posao pokrenut iz radnika ide u red tog radnika, posao sa druge niti ide radnicima redom
+        - wait() ne blokira pozivaoca bez potrebe: dok brojac nije 0 i sam izvrsava poslove
+        - GL pozivi ne smeju u poslove (kontekst je samo na glavnoj niti)
+*/
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    // workerCount 0: jedan radnik manje od broja jezgara (glavna nit pomaze u wait), najmanje jedan
+    explicit JobSystem(int workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void submit(Job job, JobCounter* counter = nullptr);
+    void wait(JobCounter& counter);
+
+    // body(begin, end) za podopsege [begin, end) velicine najvise grainSize; vraca se kad su svi gotovi
+    // (ako ceo opseg staje u jedan komad izvrsava se odmah na pozivajucoj niti)
+    void parallelFor(int begin, int end, int grainSize, const std::function<void(int, int)>& body);
+
+    int getWorkerCount() const;
+
+    // iskoriscenost po radniku (poslednji red je nit koja je pomagala u wait - obicno glavna)
+    struct WorkerStats {
+        long long jobsExecuted = 0;
+        long long jobsStolen = 0;
+        double busySeconds = 0.0;
+    };
+    WorkerStats getStats(int worker) const;
+    void resetStats();
+    void printStats() const;
+
+private:
+    struct Entry {
+        Job job;
+        JobCounter* counter;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Entry> jobs;
+        std::thread thread;
+        std::atomic<long long> jobsExecuted{ 0 };
+        std::atomic<long long> jobsStolen{ 0 };
+        std::atomic<long long> busyNanoseconds{ 0 };
+    };
+
+    // radnici + jedan slot za statistiku niti koje nisu radnici
+    std::vector<std::unique_ptr<Worker>> workers;
+    int workerCount;
+    std::atomic<bool> running{ true };
+    std::atomic<int> queuedJobs{ 0 };
+    std::atomic<unsigned int> nextWorker{ 0 };
+    std::chrono::steady_clock::time_point statsStart;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    void workerLoop(int index);
+    bool popOwn(int index, Entry& entry);
+    bool steal(int thief, Entry& entry);
+    bool tryRunOne(int index);
+    void execute(Entry& entry, int statsSlot, bool stolen);
+};
+
+/*
+    graf poslova sa zavisnostima: posao se pokrece tek kad su svi poslovi od kojih zavisi zavrseni
+    (id-jevi su redni brojevi iz add, zavisnosti moraju biti vec dodati poslovi)
+*/
+class JobGraph {
+public:
+    int add(JobSystem::Job job, const std::vector<int>& dependencies = {});
+    // pokrece sve poslove i ceka da se zavrse
+    void run(JobSystem& jobSystem);
+    int size() const;
+
+private:
+    struct Node {
+        JobSystem::Job job;
+        std::vector<int> dependents;
+        int dependencyCount = 0;
+    };
+    std::vector<Node> nodes;
+};
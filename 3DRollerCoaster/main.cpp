@@ -1,8 +1,7 @@
 ﻿#include <iostream>
 #include <fstream>
 #include <sstream>
-#include <thread>
-#include <chrono>
+#include <functional>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -14,6 +13,7 @@
 
 #include "Util.h"
 #include "shader.hpp"
+#include "shader_permutations.hpp"
 #include "model.hpp"
 
 // moji modeli
@@ -21,15 +21,44 @@
 #include "path.hpp"
 #include "rollercoaster.hpp"
 #include "cart.hpp"
+#include "cart_motion.hpp"
 #include "humanoid_model.hpp"
 
 #include "ride_controller.hpp"
+#include "ride_simulation.hpp"
+#include "benchmarks.hpp"
+#include "occlusion_culler.hpp"
+#include "dynamic_resolution.hpp"
+#include "frame_scheduler.hpp"
+#include "session_log.hpp"
+#include "job_system.hpp"
+#include "track_rebuilder.hpp"
+#include "pass_profiler.hpp"
+#include "render_on_demand.hpp"
+#include "command_buffer.hpp"
+#include "track_bundle.hpp"
 
 // modeli
 Cart* cart;
+CartMotion* cartMotion;
 
 // objekat za regulisanje voznje
 RideController* rideController;
+// simulacija voznje na posebnoj niti
+RideSimulation* rideSimulation;
+// promena putanje u toku rada (H brda, N/M amplituda, L duzina, J nagib u okretnicama)
+TrackRebuilder* trackRebuilder;
+
+// snimanje i reprodukcija sesije (--record / --replay); u oba moda simulacija ide u lockstep-u sa frejmovima
+enum class SessionMode { LIVE, RECORD, REPLAY };
+SessionMode sessionMode = SessionMode::LIVE;
+SessionRecorder sessionRecorder;
+SessionReplay sessionReplay;
+bool replayUncapped = false;   // reprodukcija bez cekanja izmedju frejmova
+
+// dogadjaji za kameru i prikaz (proizvodjac: GLFW callback-ovi, potrosac: pocetak frejma)
+SpscQueue<InputEvent, 1024> viewEvents;
+InputStats viewInputStats;
 
 // teksture
 unsigned int groundTexture;
@@ -43,14 +72,40 @@ unsigned int signatureTexture;
 float aspect;                   // aspect ratio
 int width, height;              // sirina i visina ekrana
 const double TARGET_FPS = 75.0;
-const double FRAME_TIME = 1.0 / TARGET_FPS;
 float fov = 45.0f;
-double lastFrameTime = glfwGetTime();
+
+// tempo frejmova (V menja mod: VSYNC -> FIXED -> UNCAPPED)
+FrameMode frameMode = FrameMode::FIXED;
+
+// permutacije osnovnog sejdera (bitovi maske odgovaraju redosledu #define-ova)
+enum BasicShaderFeature {
+    APPLY_GREEN = 1 << 0,   // zelena nijansa za putnika kome je muka
+    GREEN_FILTER = 1 << 1   // zeleni filter preko cele scene
+};
 
 // za toggle testiranja dubine i odstranjivanja nalicja
 bool depthTestEnabled = true;
 bool cullFaceEnabled = true;
 
+// occlusion culling za putnike, pojaseve i unutrasnjost kola
+bool occlusionCullingEnabled = true;
+const int OCCLUSION_SEATS_ID = 8;       // id-jevi 0..7 su putnici (po sedistu)
+const int OCCLUSION_CUSHIONS_ID = 9;
+const int OCCLUSION_OBJECTS = 10;
+
+
+// vremena po prolazu i broj objekata preskocenih occlusion culling-om (toggle na G, ispis svake sekunde dok je ukljuceno)
+bool passProfilingEnabled = false;
+double lastProfileReportTime = 0.0;
+
+// dinamicka rezolucija scene (opciono, toggle na R)
+bool dynamicResolutionEnabled = false;
+
+// crtanje samo kad se scena promeni (toggle na B ili --render-on-demand, samo bez snimanja/reprodukcije)
+RenderOnDemand renderOnDemand;
+bool renderOnDemandEnabled = false;
+const double IDLE_WAIT_SECONDS = 0.1;  // najduze cekanje na dogadjaj dok se nista ne menja
+
 // promenljive za nebo
 glm::vec3 skyNormal = { 0.53f, 0.81f, 0.92f };
 glm::vec3 skySick = { 0.45f, 0.75f, 0.45f };
@@ -67,10 +122,9 @@ bool toggleFpCamera = true;
 const float SIGNATURE_ASPECT = 1275.0f / 164.0f;
 float signatureScale = 0.06f; // faktor skaliranja dimenzija potpisa
 
-void drawSeatBelt(HumanoidModel& humanoid, Shader& shader, unsigned int beltTexture)
+// pojas zavisi samo od granica modela putnika, pa se pravi jednom po putniku (crta se sa matricom putnika)
+Mesh buildSeatBelt(const HumanoidModel& humanoid, unsigned int beltTexture)
 {
-    if (!humanoid.isActive) return;
-
     // dobijanje granica modela
     glm::vec3 minV = humanoid.model.getMinVertex();
     glm::vec3 maxV = humanoid.model.getMaxVertex();
@@ -182,28 +236,37 @@ void drawSeatBelt(HumanoidModel& humanoid, Shader& shader, unsigned int beltText
     Texture tex; tex.id = beltTexture; tex.type = "uDiffMap"; tex.path = "";
     textures.push_back(tex);
 
-    Mesh belt(vertices, indices, textures);
+    return Mesh(vertices, indices, textures);
+}
 
-    shader.setMat4("uM", humanoid.modelMatrix);
-    belt.Draw(shader);
+// dogadjaj iz callback-a (ili iz snimka): logika voznje ga obradjuje na pocetku koraka simulacije,
+// a kamera i toggle-ovi na pocetku frejma (processViewEvents)
+void dispatchInput(const InputEvent& event) {
+    if (sessionMode == SessionMode::RECORD)
+        sessionRecorder.recordEvent(event);
+
+    if (event.type == InputEventType::KEY_PRESS && RideSimulation::isRideKey(event.key)) {
+        rideSimulation->pushInput(event);
+        // promena stanja voznje se vidi tek posle koraka sim niti: par frejmova se crta odmah,
+        // umesto da se ceka da RenderOnDemand primeti novi snapshot posle IDLE_WAIT_SECONDS
+        renderOnDemand.markDirty();
+    }
+    else if (!viewEvents.push(event))
+        viewInputStats.dropped++;
 }
 
+// GLFW callback-ovi samo prave dogadjaje (tokom reprodukcije se ulaz ignorise)
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-    if (action != GLFW_PRESS) return;
+    if (action != GLFW_PRESS || sessionMode == SessionMode::REPLAY) return;
 
-    // na enter pocinje voznja
-    if (key == GLFW_KEY_ENTER) {
-        rideController->rideStarted();
-    }
-    // na space punimo cart putnicima
-    if (key == GLFW_KEY_SPACE) {
-        rideController->addPassanger();
-    }
-    // na tastere 1-8 "nesto radimo sa putnicima"
-    if (key >= GLFW_KEY_1 && key <= GLFW_KEY_8) {
-        int passengerIndex = key - GLFW_KEY_1;  // pretvara taster u broj 0..7
-        rideController->passangerInteraction(passengerIndex);
-    }
+    InputEvent event;
+    event.type = InputEventType::KEY_PRESS;
+    event.key = key;
+    event.timestamp = inputTimestampNow();
+    dispatchInput(event);
+}
+
+void handleViewKey(int key) {
     // toggle za kameru perspektive prvog putnika
     if (key == GLFW_KEY_C) {
         toggleFpCamera = !toggleFpCamera;
@@ -218,6 +281,49 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
         cullFaceEnabled = true;
     if (key == GLFW_KEY_P)
         cullFaceEnabled = false;
+    // toggle za occlusion culling
+    if (key == GLFW_KEY_K)
+        occlusionCullingEnabled = !occlusionCullingEnabled;
+    // toggle za dinamicku rezoluciju
+    if (key == GLFW_KEY_R)
+        dynamicResolutionEnabled = !dynamicResolutionEnabled;
+    // brzina simulacije u odnosu na realno vreme
+    if (key == GLFW_KEY_RIGHT_BRACKET)
+        rideSimulation->setTimeScale(std::min(rideSimulation->getTimeScale() * 2.0f, 16.0f));
+    if (key == GLFW_KEY_LEFT_BRACKET)
+        rideSimulation->setTimeScale(std::max(rideSimulation->getTimeScale() * 0.5f, 0.25f));
+    // promena parametara putanje u toku voznje (staza se generise u pozadini i menja kad je spremna);
+    // staza iz fajla (--track) nema ove parametre
+    if ((key == GLFW_KEY_H || key == GLFW_KEY_N || key == GLFW_KEY_M || key == GLFW_KEY_L || key == GLFW_KEY_J) &&
+        trackRebuilder->getRequestedParams().controlPoints.empty()) {
+        PathParams params = trackRebuilder->getRequestedParams();
+        if (key == GLFW_KEY_H)
+            params.hills = params.hills % 6 + 1;
+        if (key == GLFW_KEY_N)
+            params.amplitude = std::max(params.amplitude - 1.0f, 1.0f);
+        if (key == GLFW_KEY_M)
+            params.amplitude = std::min(params.amplitude + 1.0f, 8.0f);
+        if (key == GLFW_KEY_L)
+            params.length = params.length >= 60.0f ? 30.0f : params.length + 10.0f;
+        if (key == GLFW_KEY_J)
+            params.bankAngle = params.bankAngle >= 30.0f ? 0.0f : params.bankAngle + 15.0f;
+        trackRebuilder->requestRebuild(params);
+        // pri snimanju i reprodukciji zamena mora biti u istom frejmu (inace simulacija nije ponovljiva)
+        if (sessionMode != SessionMode::LIVE)
+            trackRebuilder->finishNow();
+    }
+    // crtanje samo kad se scena promeni
+    if (key == GLFW_KEY_B)
+        renderOnDemandEnabled = !renderOnDemandEnabled;
+    // merenje vremena po prolazu
+    if (key == GLFW_KEY_G)
+        passProfilingEnabled = !passProfilingEnabled;
+    // promena moda za tempo frejmova
+    if (key == GLFW_KEY_V) {
+        if (frameMode == FrameMode::VSYNC) frameMode = FrameMode::FIXED;
+        else if (frameMode == FrameMode::FIXED) frameMode = FrameMode::UNCAPPED;
+        else frameMode = FrameMode::VSYNC;
+    }
 }
 
 unsigned int preprocessTexture(const char* filepath) {
@@ -238,6 +344,18 @@ unsigned int preprocessTexture(const char* filepath) {
 }
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    if (sessionMode == SessionMode::REPLAY) return;
+
+    InputEvent event;
+    event.type = InputEventType::MOUSE_MOVE;
+    event.x = xpos;
+    event.y = ypos;
+    event.timestamp = inputTimestampNow();
+    dispatchInput(event);
+}
+
+void handleMouseMove(double xpos, double ypos)
 {
     if (firstMouse)
     {
@@ -270,8 +388,150 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
     cameraFront = glm::normalize(direction);
 }
 
-int main(void)
+// tasteri za setanje kamere koji su trenutno drzani
+uint8_t readHeldKeys(GLFWwindow* window)
+{
+    uint8_t heldKeys = 0;
+    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) heldKeys |= HELD_LEFT;
+    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) heldKeys |= HELD_RIGHT;
+    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) heldKeys |= HELD_UP;
+    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) heldKeys |= HELD_DOWN;
+    return heldKeys;
+}
+
+// prozor treba ponovo iscrtati (npr. posle preklapanja drugim prozorom)
+void windowRefreshCallback(GLFWwindow* window)
+{
+    renderOnDemand.markDirty();
+}
+
+// obrada dogadjaja za kameru i prikaz, jednom na pocetku svakog frejma
+void processViewEvents()
+{
+    InputEvent event;
+    while (viewEvents.pop(event)) {
+        viewInputStats.recordProcessed(event, inputTimestampNow());
+        renderOnDemand.markDirty();
+        if (event.type == InputEventType::KEY_PRESS)
+            handleViewKey(event.key);
+        else if (event.type == InputEventType::MOUSE_MOVE)
+            handleMouseMove(event.x, event.y);
+    }
+}
+
+// skriveni prozor samo zbog GL konteksta, za provere koje crtaju van ekrana
+int runWithHiddenContext(const std::function<int()>& check)
 {
+    if (!glfwInit())
+    {
+        std::cout << "GLFW Biblioteka se nije ucitala! :(\n";
+        return 1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "Rolerkoster", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Prozor nije napravljen! :(\n";
+        glfwTerminate();
+        return 2;
+    }
+    glfwMakeContextCurrent(window);
+    if (glewInit() != GLEW_OK)
+    {
+        std::cout << "GLEW nije mogao da se ucita! :'(\n";
+        glfwTerminate();
+        return 3;
+    }
+    int result = check();
+    glfwTerminate();
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    // dijagnosticki modovi bez prozora
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--stress-triple-buffer")
+            return runTripleBufferStress(i + 1 < argc ? std::atof(argv[i + 1]) : 5.0);
+        if (arg == "--bench-track")
+            return runTrackGenerationBench();
+        if (arg == "--check-path")
+            return runPathDerivativeCheck();
+        if (arg == "--bench-path")
+            return runPathBatchBench();
+        if (arg == "--bench-bundle")
+            return runTrackBundleBench();
+        if (arg == "--bench-tessellation")
+            return runTrackTessellationBench(i + 1 < argc ? argv[i + 1] : "res/tracks/lift_hill.txt");
+        if (arg == "--bench-sweep")
+            return runSweepBench();
+        if (arg == "--check-spline")
+            return runSplinePathCheck(i + 1 < argc ? argv[i + 1] : "res/tracks/lift_hill.txt");
+        if (arg == "--check-gpu-rails") {
+            // racun na CPU prema generateRails, pa pravi sejderi i crtanje van ekrana
+            std::string file = i + 1 < argc ? argv[i + 1] : "res/tracks/lift_hill.txt";
+            int result = runGpuRailsCheck(file);
+            int renderResult = runWithHiddenContext([&]() { return runGpuRailsRenderCheck(file); });
+            return result != 0 ? result : renderResult;
+        }
+        if (arg == "--headless")
+            return runHeadlessRides(i + 1 < argc ? std::atoi(argv[i + 1]) : 1000);
+    }
+
+    std::string sessionPath;
+    std::string trackFile;
+    std::string bundleFile;
+    bool railsOnGpu = false;    // --gpu-rails: sine se izvlace u vertex sejderu iz okvira u cvorovima
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--record" || arg == "--replay") && i + 1 < argc) {
+            sessionMode = arg == "--record" ? SessionMode::RECORD : SessionMode::REPLAY;
+            sessionPath = argv[++i];
+        }
+        if (arg == "--uncapped")
+            replayUncapped = true;
+        if (arg == "--render-on-demand")
+            renderOnDemandEnabled = true;
+        if (arg == "--track" && i + 1 < argc)
+            trackFile = argv[++i];
+        if (arg == "--bundle" && i + 1 < argc)
+            bundleFile = argv[++i];
+        if (arg == "--gpu-rails")
+            railsOnGpu = true;
+    }
+    if (sessionMode == SessionMode::REPLAY && !sessionReplay.load(sessionPath))
+        return 4;
+    // snimak vazi samo za stazu sa kojom je snimljen
+    if (sessionMode == SessionMode::REPLAY) {
+        const SessionConfig& config = sessionReplay.getConfig();
+        bool sameSetup = true;
+        if (config.trackFile != trackFile) {
+            std::cout << "Reprodukcija sesije: snimljeno sa stazom \"" << (config.trackFile.empty() ? "ugradjena" : config.trackFile)
+                << "\", sada \"" << (trackFile.empty() ? "ugradjena" : trackFile) << "\" (--track)" << std::endl;
+            sameSetup = false;
+        }
+        if (config.bundleFile != bundleFile) {
+            std::cout << "Reprodukcija sesije: snimljeno sa --bundle \"" << config.bundleFile
+                << "\", sada \"" << bundleFile << "\"" << std::endl;
+            sameSetup = false;
+        }
+        if ((bool)config.gpuRails != railsOnGpu) {
+            std::cout << "Reprodukcija sesije: snimljeno " << (config.gpuRails ? "sa" : "bez") << " --gpu-rails, sada "
+                << (railsOnGpu ? "sa" : "bez") << std::endl;
+            sameSetup = false;
+        }
+        if (!sameSetup)
+            return 7;
+    }
+    // staza iz fajla umesto ugradjene (ucitava se pre prozora, da greska u fajlu ne otvara prazan prozor)
+    std::vector<TrackControlPoint> trackPoints;
+    if (!trackFile.empty() && !Path::loadControlPoints(trackFile, trackPoints))
+        return 6;
+
     if (!glfwInit())
     {
         std::cout<<"GLFW Biblioteka se nije ucitala! :(\n";
@@ -297,6 +557,7 @@ int main(void)
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetKeyCallback(window, keyCallback);
     glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetWindowRefreshCallback(window, windowRefreshCallback);
     
     if (window == NULL)
     {
@@ -319,8 +580,13 @@ int main(void)
     
     unsigned int signatureVAO, signatureVBO, signatureEBO;
 
-    Shader basicShader("basic.vert", "basic.frag");
+    ShaderPermutations basicShaders("basic.vert", "basic.frag", { "APPLY_GREEN", "GREEN_FILTER" });
+    // sine na GPU (samo sa --gpu-rails): isti fragment sejder i permutacije, verteksi iz okvira putanje (GpuRails)
+    std::unique_ptr<ShaderPermutations> railShaders;
+    if (railsOnGpu)
+        railShaders = std::make_unique<ShaderPermutations>("rail_gpu.vert", "basic.frag", std::vector<std::string>{ "APPLY_GREEN", "GREEN_FILTER" });
     Shader signatureShader("signature.vert", "signature.frag");
+    std::cout << "Kes sejder programa je ustedeo " << Shader::getTotalSavedMs() << " ms pri pokretanju\n";
 
     // ucitavanje tekstura
     groundTexture = preprocessTexture("res/grass.jpg");
@@ -366,59 +632,118 @@ int main(void)
     glClearColor(0.53f, 0.81f, 0.92f, 1.0f); // nebo
     glCullFace(GL_BACK);// biranje lica koje ce se eliminisati (tek nakon sto ukljucimo Face Culling)
 
-    basicShader.use();
-    basicShader.setVec3("uLightPos", 10, 7, 3);
-    basicShader.setVec3("uLightPos", -20, 3, -20);
-    // basicShader.setVec3("uLightPos", 0, 4, 5);
-    basicShader.setVec3("uViewPos", 0, 0, 5);
-    basicShader.setVec3("uLightColor", 1, 1, 1);
     glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
-    basicShader.setMat4("uP", projection);
     glm::vec3 cameraPos = glm::vec3(0.0f, 1.0f, 10.0f);
     glm::vec3 cameraUp = glm::vec3(0.0, 1.0, 0.0);
     glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront ,cameraUp);
-    basicShader.setMat4("uV", view);
-    glm::mat4 model = glm::mat4(1.0f);
-    basicShader.setMat4("uM", model);
     glm::mat4 projectionP = glm::perspective(glm::radians(fov), aspect, 0.1f, 100.0f);
-    basicShader.setMat4("uP", projectionP);
-
-    // ucitavanje modela ljudi
-    std::vector<HumanoidModel> seatedHumanoids;
-    seatedHumanoids.emplace_back("res/models/humanoid1/model.obj", 0); // sediste 0
-    seatedHumanoids.emplace_back("res/models/humanoid2/model.obj", 1); // sediste 1
-    seatedHumanoids.emplace_back("res/models/humanoid3/green swat.obj", 2); // sediste 2
-    seatedHumanoids.emplace_back("res/models/humanoid4/model.obj", 3); // sediste 3
-    seatedHumanoids.emplace_back("res/models/humanoid5/091_W_Aya_10K.obj", 4); // sediste 4
-    seatedHumanoids.emplace_back("res/models/humanoid6/Madara_Uchiha.obj", 5); // sediste 5
-    seatedHumanoids.emplace_back("res/models/humanoid7/model.obj", 6); // sediste 6
-    seatedHumanoids.emplace_back("res/models/humanoid8/luke dagobah.obj", 7); // sediste 7
-
-    // kontroler za voznju
-    rideController = new RideController(seatedHumanoids);
+    // uniforme koje su iste za sve permutacije
+    auto setSceneUniforms = [&](Shader& basicShader) {
+        basicShader.setVec3("uLightPos", 10, 7, 3);
+        basicShader.setVec3("uLightPos", -20, 3, -20);
+        // basicShader.setVec3("uLightPos", 0, 4, 5);
+        basicShader.setVec3("uViewPos", 0, 0, 5);
+        basicShader.setVec3("uLightColor", 1, 1, 1);
+        basicShader.setMat4("uP", projection);
+        basicShader.setMat4("uV", view);
+        // tekstura je uvek na jedinici 0
+        basicShader.setInt("uDiffMap1", 0);
+        basicShader.setMat4("uP", projectionP);
+    };
+    basicShaders.forEach([&](Shader& basicShader) {
+        setSceneUniforms(basicShader);
+        // uM je u uniform bloku Object (postavlja ga CommandReplayer)
+        CommandReplayer::bindObjectBlock(basicShader);
+    });
+    if (railShaders)
+        railShaders->forEach(setSceneUniforms);
+
+    // job sistem za ucitavanje, generisanje staze i azuriranje scene po frejmu (snimanje komandi)
+    JobSystem jobSystem;
+
+    // ucitavanje modela ljudi: Assimp i dekodiranje tekstura idu na radnicima dok glavna nit pravi stazu,
+    // GL deo (uploadToGPU) je posle na glavnoj niti
+    const char* humanoidPaths[] = {
+        "res/models/humanoid1/model.obj",           // sediste 0
+        "res/models/humanoid2/model.obj",           // sediste 1
+        "res/models/humanoid3/green swat.obj",      // sediste 2
+        "res/models/humanoid4/model.obj",           // sediste 3
+        "res/models/humanoid5/091_W_Aya_10K.obj",   // sediste 4
+        "res/models/humanoid6/Madara_Uchiha.obj",   // sediste 5
+        "res/models/humanoid7/model.obj",           // sediste 6
+        "res/models/humanoid8/luke dagobah.obj"     // sediste 7
+    };
+    const int HUMANOID_COUNT = sizeof(humanoidPaths) / sizeof(humanoidPaths[0]);
+    std::vector<std::unique_ptr<HumanoidModel>> loadedHumanoids(HUMANOID_COUNT);
+    JobCounter humanoidsLoaded;
+    for (int i = 0; i < HUMANOID_COUNT; i++)
+        jobSystem.submit([&loadedHumanoids, &humanoidPaths, i]() {
+            loadedHumanoids[i] = std::make_unique<HumanoidModel>(humanoidPaths[i], i, false);
+        }, &humanoidsLoaded);
 
     // kreiranje ground-a: sirina=50, duzina=50, subdivisions=50, tekstura
     Ground ground(100.0f, 100.0f, 75, groundTexture);
 
     glm::vec3 origin = glm::vec3(-20, 0, 0);
     // kreiranje putanje (koriste je rollercoaster i cart)
-    Path path(
-        40.0f,  // duzina
-        3.0f,   // offset za deo puta za povratak unazad (po z osi koliko su delovi puta za napred i nazad udaljeni)
-        1.0f,   // pocetna visina
-        4.0f,   // amplitude (za vrhove i doline)
-        3,      // broj brda
-        origin
-        );
+    PathParams pathParams;
+    pathParams.length = 40.0f;          // duzina
+    pathParams.returnOffsetZ = 3.0f;    // offset za deo puta za povratak unazad (po z osi koliko su delovi puta za napred i nazad udaljeni)
+    pathParams.baseHeight = 1.0f;       // pocetna visina
+    pathParams.amplitude = 4.0f;        // amplitude (za vrhove i doline)
+    pathParams.hills = 3;               // broj brda
+    pathParams.origin = origin;
+    pathParams.controlPoints = trackPoints;     // --track: ako nije prazno, ostalo osim origin se ne koristi
+    const float TRACK_WIDTH = 1.2f;     // sirina sina
+    const float RAIL_THICKNESS = 0.2f;  // debljina samog rail-a
+    const int TRACK_SAMPLES = 5000;     // rezolucija (mreza na kojoj se biraju krajevi kvadara sina)
+    TrackTessellation tessellation;     // sine: najvise 1 mm od stvarne sine i 2 m po kvadru (--bench-tessellation)
+    tessellation.tolerance = 0.001f;
+    tessellation.maxSegmentLength = 2.0f;
+
+    // --bundle: pecena staza od istih parametara se samo mapira (tabele putanje i geometrija), inace se pravi i peca
+    auto trackStart = std::chrono::steady_clock::now();
+    TrackBundle trackBundle;
+    bool bundleLoaded = !bundleFile.empty() && trackBundle.open(bundleFile) &&
+        trackBundle.matches(pathParams, TRACK_WIDTH, RAIL_THICKNESS, TRACK_SAMPLES, tessellation);
+    Path path = bundleLoaded ? Path(pathParams, trackBundle.getPathTables()) : Path(pathParams);
     // kreiranje rolerkostera
     RollerCoaster rollercoaster(
-        &path, // putanja
-        1.2f,  // sirina sina
-        0.2f,  // debljina samog rail-a
-        5000,  // rezolucija
+        &path,
+        TRACK_WIDTH,
+        RAIL_THICKNESS,
+        TRACK_SAMPLES,
+        tessellation,
         metalTexture,
-        woodTexture
+        woodTexture,
+        &jobSystem,
+        bundleLoaded ? &trackBundle : nullptr,
+        railsOnGpu
     );
+    double trackMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - trackStart).count();
+    if (bundleLoaded) {
+        // podaci su u GL baferima i u tabelama putanje, mapiranje vise ne treba
+        trackBundle.close();
+        std::cout << "Pecena staza ucitana iz " << bundleFile << " za " << trackMs << " ms" << std::endl;
+    }
+    else if (!bundleFile.empty() && railsOnGpu) {
+        // bez mesh-a sina pecena staza ne bi bila potpuna za obican mod
+        std::cout << "Staza nije pecena u " << bundleFile << ": sa --gpu-rails nema geometrije sina" << std::endl;
+    }
+    else if (!bundleFile.empty()) {
+        TrackPartView parts[TrackBundle::PART_COUNT];
+        for (int part = 0; part < TrackBundle::PART_COUNT; part++) {
+            const Mesh& mesh = rollercoaster.meshes[part];
+            parts[part] = { mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size() };
+        }
+        if (TrackBundle::write(bundleFile, path, TRACK_WIDTH, RAIL_THICKNESS, TRACK_SAMPLES, tessellation, parts))
+            std::cout << "Staza napravljena za " << trackMs << " ms i pecena u " << bundleFile << std::endl;
+    }
+    if (railsOnGpu) {
+        const GpuRails& gpuRails = rollercoaster.getGpuRails();
+        std::cout << "Sine na GPU: " << gpuRails.getSegmentCount() << " segmenata, okviri " << gpuRails.getSampleBytes() / 1024
+            << " KB, sablon " << gpuRails.getTemplateVertexCount() << " verteksa" << std::endl;
+    }
     // kreiranje cart-a
     cart = new Cart(
         &path,  // putanja
@@ -428,47 +753,167 @@ int main(void)
         0.05f,  // wall thickness
         cartTexture,
         woodTexture,
-        plasticTexture,
-        seatedHumanoids,
-        rideController
+        plasticTexture
     );
 
+    jobSystem.wait(humanoidsLoaded);
+    std::vector<HumanoidModel> seatedHumanoids;
+    seatedHumanoids.reserve(HUMANOID_COUNT);
+    for (std::unique_ptr<HumanoidModel>& humanoid : loadedHumanoids) {
+        humanoid->model.uploadToGPU();
+        seatedHumanoids.push_back(std::move(*humanoid));
+    }
+    loadedHumanoids.clear();
+    std::vector<Mesh> seatBelts;
+    for (const HumanoidModel& humanoid : seatedHumanoids)
+        seatBelts.push_back(buildSeatBelt(humanoid, plasticTexture));
+
+    // kontroler za voznju radi nad stanjem putnika (bez modela)
+    std::vector<Passenger*> passengers;
+    for (HumanoidModel& humanoid : seatedHumanoids)
+        passengers.push_back(&humanoid);
+    rideController = new RideController(passengers);
+
+    // kretanje kola po putanji
+    cartMotion = new CartMotion(&path, rideController);
+
+    // od ovog trenutka kola, kontroler i stanje putnika menja samo sim nit
+    rideSimulation = new RideSimulation(cartMotion, rideController, passengers);
+
+    trackRebuilder = new TrackRebuilder(&rollercoaster, cart, cartMotion, rideSimulation, &path);
+
+    OcclusionCuller occlusionCuller(OCCLUSION_OBJECTS);
+
+    // komande za crtanje scene: svaki posao puni svoj buffer, GL nit ih samo izvrsava
+    CommandReplayer commandReplayer;
+    CommandBuffer groundCommands, trackCommands, cartCommands;
+    CommandBuffer humanoidCommands[MAX_PASSENGERS], beltCommands[MAX_PASSENGERS];
+    std::vector<CommandBuffer*> sceneCommands = { &groundCommands, &trackCommands, &cartCommands };
+    for (int i = 0; i < MAX_PASSENGERS; i++)
+        sceneCommands.push_back(&humanoidCommands[i]);
+    for (int i = 0; i < MAX_PASSENGERS; i++)
+        sceneCommands.push_back(&beltCommands[i]);
+
+    DynamicResolutionConfig resolutionConfig;
+    resolutionConfig.minScale = 0.5f;
+    resolutionConfig.maxScale = 1.0f;
+    resolutionConfig.hysteresisFrames = 20;
+    DynamicResolution dynamicResolution(width, height, TARGET_FPS, resolutionConfig);
+
+    // pocetna konfiguracija sesije: pri snimanju se upisuje, pri reprodukciji se vraca
+    if (sessionMode == SessionMode::REPLAY) {
+        const SessionConfig& config = sessionReplay.getConfig();
+        if (config.width != width || config.height != height)
+            std::cout << "Reprodukcija sesije: snimljeno na " << config.width << "x" << config.height
+                << ", sada " << width << "x" << height << " (simulacija je ista, crtanje nije)" << std::endl;
+        frameMode = replayUncapped ? FrameMode::UNCAPPED : (FrameMode)config.frameMode;
+        rideSimulation->setTimeScale(config.timeScale);
+        depthTestEnabled = config.depthTest;
+        cullFaceEnabled = config.cullFace;
+        occlusionCullingEnabled = config.occlusionCulling;
+        dynamicResolutionEnabled = config.dynamicResolution;
+        toggleFpCamera = config.fpCamera;
+        firstMouse = config.firstMouse;
+        lastX = config.lastX;
+        lastY = config.lastY;
+        yaw = config.yaw;
+        pitch = config.pitch;
+        cameraPos = config.cameraPos;
+        cameraFront = config.cameraFront;
+    }
+    if (sessionMode == SessionMode::RECORD) {
+        SessionConfig config;
+        config.width = width;
+        config.height = height;
+        config.frameMode = (int32_t)frameMode;
+        config.timeScale = rideSimulation->getTimeScale();
+        config.depthTest = depthTestEnabled;
+        config.cullFace = cullFaceEnabled;
+        config.occlusionCulling = occlusionCullingEnabled;
+        config.dynamicResolution = dynamicResolutionEnabled;
+        config.fpCamera = toggleFpCamera;
+        config.firstMouse = firstMouse;
+        config.lastX = lastX;
+        config.lastY = lastY;
+        config.yaw = yaw;
+        config.pitch = pitch;
+        config.cameraPos = cameraPos;
+        config.cameraFront = cameraFront;
+        config.trackFile = trackFile;
+        config.bundleFile = bundleFile;
+        config.gpuRails = railsOnGpu;
+        if (!sessionRecorder.open(sessionPath, config))
+            sessionMode = SessionMode::LIVE;
+    }
+    // ako snimanje ne moze da pocne, simulacija radi na svojoj niti kao inace
+    if (sessionMode == SessionMode::LIVE)
+        rideSimulation->start();
+    std::vector<InputEvent> replayEvents;
+    long long sessionFrames = 0;
+    double sessionStartTime = glfwGetTime();
+
+    PassProfiler passProfiler;
+
+    FrameScheduler frameScheduler(TARGET_FPS, frameMode);
+    frameScheduler.setRefreshRate(mode->refreshRate);
+    frameScheduler.setMode(frameMode);
+
     glEnable(GL_DEPTH_TEST); // inicijalno ukljucivanje Z bafera (kasnije mozemo da iskljucujemo i opet ukljucujemo)
     glEnable(GL_CULL_FACE); // inicijalno ukljucivanje (back)face culling-a
 
     while (!glfwWindowShouldClose(window))
     {
-        // fps
-        double now = glfwGetTime();
-        double timePassed = now - lastFrameTime;
-        if (timePassed < FRAME_TIME) {
-            double waitTime = FRAME_TIME - timePassed;
-            std::this_thread::sleep_for(std::chrono::duration<double>(waitTime));
-            continue;
+        // fps - scheduler ceka pocetak frejma, pa se ulaz cita neposredno pre crtanja
+        if (replayUncapped)
+            frameMode = FrameMode::UNCAPPED;
+        if (frameScheduler.getMode() != frameMode) {
+            frameScheduler.printStats();
+            frameScheduler.setMode(frameMode);
+            std::cout << "Mod frejmova: " << frameModeName(frameMode) << std::endl;
         }
-        lastFrameTime = now;
-
-        bool sickView =
-            toggleFpCamera &&
-            seatedHumanoids[0].isActive &&
-            seatedHumanoids[0].isSick;
-
-        if (sickView)
-            glClearColor(skySick.r, skySick.g, skySick.b, 1.0f);
-        else
-            glClearColor(skyNormal.r, skyNormal.g, skyNormal.b, 1.0f);
-
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // osvezavamo i Z bafer i bafer boje
-
-        if (depthTestEnabled)
-            glEnable(GL_DEPTH_TEST);
-        else
-            glDisable(GL_DEPTH_TEST);
+        float frameTime = (float)frameScheduler.beginFrame();
+        double now = glfwGetTime();
+        glfwPollEvents();
 
-        if (cullFaceEnabled)
-            glEnable(GL_CULL_FACE);
-        else
-            glDisable(GL_CULL_FACE);
+        // ulaz i dt frejma: iz snimka ili sa GLFW-a (koji se tada i snima)
+        uint8_t heldKeys = 0;
+        if (sessionMode == SessionMode::REPLAY) {
+            if (sessionReplay.isFinished())
+                break;
+            frameTime = sessionReplay.nextFrame(heldKeys, replayEvents);
+            for (const InputEvent& event : replayEvents)
+                dispatchInput(event);
+        }
+        else {
+            heldKeys = readHeldKeys(window);
+            if (sessionMode == SessionMode::RECORD)
+                sessionRecorder.endFrame(frameTime, heldKeys);
+        }
+        sessionFrames++;
+        processViewEvents();
+        if (heldKeys != 0)
+            renderOnDemand.markDirty();
+        // nova staza (ako se generise): deo upload-a u ovom frejmu, zamena na granici frejma
+        if (trackRebuilder->isBusy())
+            renderOnDemand.markDirty();
+        trackRebuilder->update();
+
+        // stanje voznje i interpolirana poza kola i putnika: ili najnoviji snapshot sa sim niti (bez cekanja),
+        // ili koraci za ovaj frejm na render niti (snimanje/reprodukcija)
+        float alpha = 0.0f;
+        if (sessionMode != SessionMode::LIVE)
+            alpha = rideSimulation->stepFrame(frameTime);
+        const SceneSnapshot& snapshot = rideSimulation->acquireSnapshot();
+        if (sessionMode == SessionMode::LIVE)
+            alpha = RideSimulation::interpolationAlpha(snapshot, RideSimulation::clockNow());
+        float cartT = snapshot.prevT + (snapshot.t - snapshot.prevT) * alpha;
+        glm::mat4 cartMatrix = cart->computeModelMatrix(cartT);
+        glm::mat4 humanoidMatrices[MAX_PASSENGERS];
+        int humanoidCount = (int)std::min(seatedHumanoids.size(), (size_t)MAX_PASSENGERS);
+        // najvise 8 proizvoda matrica: jeftinije odmah nego preko poslova; posao po frejmu na radnicima
+        // je obilazak scene i snimanje komandi (SNIMANJE KOMANDI), koji ove matrice samo cita
+        for (int i = 0; i < humanoidCount; i++)
+            humanoidMatrices[i] = cart->computeHumanoidMatrix(seatedHumanoids[i], cartMatrix);
 
         // izlaz na ESC
         if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -477,42 +922,36 @@ int main(void)
         }
 
         // walk around camera
-        if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+        if (heldKeys & HELD_LEFT)
         {   
             cameraPos += movementSpeedMult * glm::normalize(glm::vec3(cameraFront.z, 0, -cameraFront.x));
         }
-        if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+        if (heldKeys & HELD_RIGHT)
         {
             cameraPos -= movementSpeedMult * glm::normalize(glm::vec3(cameraFront.z, 0, -cameraFront.x));
         }
-        if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        if (heldKeys & HELD_UP)
         {
             cameraPos += movementSpeedMult * glm::normalize(glm::vec3(cameraFront.x, 0, cameraFront.z));
         }
-        if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+        if (heldKeys & HELD_DOWN)
         {
             cameraPos -= movementSpeedMult * glm::normalize(glm::vec3(cameraFront.x, 0, cameraFront.z));
         }
 
-        basicShader.use();
-        glm::mat4 groundModel = glm::mat4(1.0f);
-        basicShader.setMat4("uM", groundModel);
-        view = glm::lookAt(cameraPos, cameraFront + cameraPos, cameraUp);
-        basicShader.setMat4("uV", view);
-
-        HumanoidModel& fpHumanoid = seatedHumanoids[0];
+        const glm::mat4& fpHumanoidMatrix = humanoidMatrices[0];
         glm::vec3 fpCameraPos;
         glm::vec3 fpCameraFront;
 
-        if (fpHumanoid.isActive && toggleFpCamera) {
+        if (snapshot.passengers[0].isActive && toggleFpCamera) {
             float headHeight = 1.9f; // visina glave (recimo kao)
 
             // forward vektor humanoida iz model matrix
-            glm::vec3 humanoidForward = glm::normalize(glm::vec3(fpHumanoid.modelMatrix * glm::vec4(0.0f, 0.0f, 1.0f, 0.0f)));
+            glm::vec3 humanoidForward = glm::normalize(glm::vec3(fpHumanoidMatrix * glm::vec4(0.0f, 0.0f, 1.0f, 0.0f)));
 
             // kamera je malo ispred glave (headHeight + cameraOffset)
             const float cameraOffset = 0.3f; // koliko je kamera ispred glave
-            fpCameraPos = glm::vec3(fpHumanoid.modelMatrix * glm::vec4(0.0f, headHeight, 0.0f, 1.0f)) + humanoidForward * cameraOffset;
+            fpCameraPos = glm::vec3(fpHumanoidMatrix * glm::vec4(0.0f, headHeight, 0.0f, 1.0f)) + humanoidForward * cameraOffset;
 
             // pravljenje front vektora kamere iz yaw/pitch
             fpCameraFront.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
@@ -526,37 +965,178 @@ int main(void)
             fpCameraFront = cameraFront;
         }
 
-        basicShader.setBool("greenFilterOn", sickView);
-
         view = glm::lookAt(fpCameraPos, fpCameraPos + fpCameraFront, cameraUp);
-        basicShader.setMat4("uV", view);
 
-        // ======= ISCRTAVANJE MODELA ========
-        // crtanje ground-a
-        ground.Draw(basicShader);
-
-        // crtanje rolerkostera
-        rollercoaster.Draw(basicShader);
-
-        // crtanje cart-a
-        float deltaTime = static_cast<float>(timePassed);
-        cart->setDeltaTime(deltaTime);
-        cart->update();
-        basicShader.setMat4("uM", cart->getModelMatrix());
-        cart->Draw(basicShader);
-
-        // crtanje ljudi
-        for (HumanoidModel& humanoid : seatedHumanoids) {
-            if (!humanoid.isActive)
+        // ako se od poslednjeg nacrtanog frejma nista nije promenilo, na ekranu ostaje ta slika;
+        // umesto crtanja se ceka na dogadjaj (ili dok ne istekne IDLE_WAIT_SECONDS)
+        bool onDemand = renderOnDemandEnabled && sessionMode == SessionMode::LIVE;
+        if (renderOnDemand.isEnabled() != onDemand)
+            renderOnDemand.setEnabled(onDemand);
+        if (!renderOnDemand.shouldRender(view, snapshot, cartT)) {
+            glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+            frameScheduler.skipFrame();
+            continue;
+        }
+
+        if (passProfiler.isEnabled() != passProfilingEnabled)
+            passProfiler.setEnabled(passProfilingEnabled);
+        passProfiler.beginFrame();
+        basicShaders.forEach([&](Shader& basicShader) {
+            basicShader.setMat4("uV", view);
+        });
+        if (railShaders)
+            railShaders->forEach([&](Shader& railShader) {
+                railShader.setMat4("uV", view);
+            });
+
+        if (dynamicResolution.isEnabled() != dynamicResolutionEnabled) {
+            dynamicResolution.setEnabled(dynamicResolutionEnabled);
+            // odbijeno ukljucivanje (framebuffer nije kompletan) se ne pokusava svaki frejm
+            dynamicResolutionEnabled = dynamicResolution.isEnabled();
+        }
+        // scena se crta u offscreen framebuffer (ako je dinamicka rezolucija ukljucena)
+        dynamicResolution.beginScene();
+
+        bool sickView =
+            toggleFpCamera &&
+            snapshot.passengers[0].isActive &&
+            snapshot.passengers[0].isSick;
+
+        if (sickView)
+            glClearColor(skySick.r, skySick.g, skySick.b, 1.0f);
+        else
+            glClearColor(skyNormal.r, skyNormal.g, skyNormal.b, 1.0f);
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // osvezavamo i Z bafer i bafer boje
+
+        if (depthTestEnabled)
+            glEnable(GL_DEPTH_TEST);
+        else
+            glDisable(GL_DEPTH_TEST);
+
+        if (cullFaceEnabled)
+            glEnable(GL_CULL_FACE);
+        else
+            glDisable(GL_CULL_FACE);
+
+        // permutacija za celu scenu, putnicima kome je muka se dodaje APPLY_GREEN
+        unsigned int sceneFeatures = sickView ? GREEN_FILTER : 0;
+        Shader& basicShader = basicShaders.get(sceneFeatures);
+
+        if (occlusionCuller.isEnabled() != occlusionCullingEnabled)
+            occlusionCuller.setEnabled(occlusionCullingEnabled);
+        occlusionCuller.beginFrame();
+
+        // vidljivost iz prethodnog frejma i box-ovi za nove upite se odredjuju ovde (culler nije thread-safe),
+        // poslovi za snimanje komandi samo citaju rezultat
+        bool seatsVisible = occlusionCuller.isVisible(OCCLUSION_SEATS_ID);
+        bool cushionsVisible = occlusionCuller.isVisible(OCCLUSION_CUSHIONS_ID);
+        if (!seatsVisible)
+            occlusionCuller.markSkipped();
+        if (!cushionsVisible)
+            occlusionCuller.markSkipped();
+        occlusionCuller.addBox(OCCLUSION_SEATS_ID, cart->getPartMin(Cart::SEATS), cart->getPartMax(Cart::SEATS), cartMatrix);
+        occlusionCuller.addBox(OCCLUSION_CUSHIONS_ID, cart->getPartMin(Cart::CUSHIONS), cart->getPartMax(Cart::CUSHIONS), cartMatrix);
+
+        bool humanoidVisible[MAX_PASSENGERS] = {};
+        for (int i = 0; i < humanoidCount; i++) {
+            const HumanoidModel& humanoid = seatedHumanoids[i];
+            const PassengerSnapshot& passenger = snapshot.passengers[i];
+            if (!passenger.isActive)
                 continue;
-            basicShader.setMat4("uM", humanoid.modelMatrix);
-            basicShader.setBool("applyGreen", humanoid.isSick);
-            humanoid.model.Draw(basicShader);
-            // crtanje pojaseva
-            if (humanoid.isBeltOn)
-                drawSeatBelt(humanoid, basicShader, plasticTexture);
+            // pojas je unutar bounding box-a putnika pa deli isti upit
+            occlusionCuller.addBox(humanoid.seatIndex, humanoid.model.getMinVertex(), humanoid.model.getMaxVertex(), humanoidMatrices[i]);
+            humanoidVisible[i] = occlusionCuller.isVisible(humanoid.seatIndex);
+            if (!humanoidVisible[i]) {
+                occlusionCuller.markSkipped();
+                if (passenger.isBeltOn)
+                    occlusionCuller.markSkipped();
+            }
+        }
+
+        // ======= SNIMANJE KOMANDI ========
+        // scena se obilazi na radnicima, po jedan posao za svaki deo scene (ground, staza, kola, putnik sa pojasom);
+        // svaki posao puni samo svoj buffer, GL nit ceka da svi zavrse pa samo salje matrice i izvrsava komande
+        {
+            ProfileScope pass(passProfiler, "record");
+            JobCounter commandsRecorded;
+            jobSystem.submit([&]() {
+                groundCommands.clear();
+                groundCommands.draw(basicShader, ground, groundCommands.addObject(glm::mat4(1.0f)));
+            }, &commandsRecorded);
+            jobSystem.submit([&]() {
+                trackCommands.clear();
+                trackCommands.draw(basicShader, rollercoaster, trackCommands.addObject(glm::mat4(1.0f)));
+            }, &commandsRecorded);
+            jobSystem.submit([&]() {
+                // sedista i cushion-i se crtaju samo ako se u prethodnom frejmu videli (ili nemamo rezultat)
+                cartCommands.clear();
+                unsigned int cartObject = cartCommands.addObject(cartMatrix);
+                cartCommands.draw(basicShader, cart->getPart(Cart::BODY), cartObject);
+                if (seatsVisible)
+                    cartCommands.draw(basicShader, cart->getPart(Cart::SEATS), cartObject);
+                if (cushionsVisible)
+                    cartCommands.draw(basicShader, cart->getPart(Cart::CUSHIONS), cartObject);
+            }, &commandsRecorded);
+            for (int i = 0; i < MAX_PASSENGERS; i++) {
+                jobSystem.submit([&, i]() {
+                    humanoidCommands[i].clear();
+                    beltCommands[i].clear();
+                    if (i >= humanoidCount || !snapshot.passengers[i].isActive || !humanoidVisible[i])
+                        return;
+                    const PassengerSnapshot& passenger = snapshot.passengers[i];
+                    Shader& humanoidShader = basicShaders.get(sceneFeatures | (passenger.isSick ? APPLY_GREEN : 0));
+                    humanoidCommands[i].draw(humanoidShader, seatedHumanoids[i].model, humanoidCommands[i].addObject(humanoidMatrices[i]));
+                    if (passenger.isBeltOn)
+                        beltCommands[i].draw(humanoidShader, seatBelts[i], beltCommands[i].addObject(humanoidMatrices[i]));
+                }, &commandsRecorded);
+            }
+            jobSystem.wait(commandsRecorded);
+            commandReplayer.upload(sceneCommands);
+        }
+
+        // ======= ISCRTAVANJE MODELA ========
+        {
+            ProfileScope pass(passProfiler, "ground");
+            commandReplayer.replay(groundCommands);
+        }
+
+        {
+            ProfileScope pass(passProfiler, "track");
+            commandReplayer.replay(trackCommands);
+            // mesh sina je tada prazan (preskocen pri snimanju komandi), sine se izvlace u sejderu
+            if (railShaders && rollercoaster.hasGpuRails())
+                rollercoaster.getGpuRails().draw(railShaders->get(sceneFeatures));
+        }
+
+        {
+            ProfileScope pass(passProfiler, "cart");
+            commandReplayer.replay(cartCommands);
+        }
+
+        {
+            ProfileScope pass(passProfiler, "humanoids");
+            for (int i = 0; i < MAX_PASSENGERS; i++)
+                commandReplayer.replay(humanoidCommands[i]);
+        }
+
+        {
+            ProfileScope pass(passProfiler, "belts");
+            for (int i = 0; i < MAX_PASSENGERS; i++)
+                commandReplayer.replay(beltCommands[i]);
+        }
+
+        // upiti za occlusion culling (rezultate citamo u sledecem frejmu)
+        {
+            ProfileScope pass(passProfiler, "occlusion");
+            occlusionCuller.issueQueries(view, projectionP);
+        }
+
+        // scena se razvlaci na ekran, potpis se crta u nativnoj rezoluciji
+        {
+            ProfileScope pass(passProfiler, "resolve");
+            dynamicResolution.endScene();
         }
-        basicShader.setBool("applyGreen", false);
 
         bool prevDepth = depthTestEnabled;
         bool prevCull = cullFaceEnabled;
@@ -566,45 +1146,100 @@ int main(void)
         glDisable(GL_CULL_FACE);
 
         // crtanje potpisa
-        signatureShader.use();
+        {
+            ProfileScope pass(passProfiler, "signature");
+            signatureShader.use();
 
-        // ortho projekcija (screen space)
-        glm::mat4 ortho = glm::ortho(
-            0.0f, (float)width,
-            0.0f, (float)height
-        );
+            // ortho projekcija (screen space)
+            glm::mat4 ortho = glm::ortho(
+                0.0f, (float)width,
+                0.0f, (float)height
+            );
 
-        // velicina potpisa
-        float sigH = height * signatureScale;
-        float sigW = sigH * SIGNATURE_ASPECT;
+            // velicina potpisa
+            float sigH = height * signatureScale;
+            float sigW = sigH * SIGNATURE_ASPECT;
 
-        // gornji levi ugao
-        float x = 20.0f;
-        float y = height - sigH - 20.0f;
+            // gornji levi ugao
+            float x = 20.0f;
+            float y = height - sigH - 20.0f;
 
-        glm::mat4 model2D = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
-        model2D = glm::scale(model2D, glm::vec3(sigW, sigH, 1.0f));
+            glm::mat4 model2D = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
+            model2D = glm::scale(model2D, glm::vec3(sigW, sigH, 1.0f));
 
-        glm::mat4 mvp = ortho * model2D;
-        signatureShader.setMat4("uMVP", mvp);
+            glm::mat4 mvp = ortho * model2D;
+            signatureShader.setMat4("uMVP", mvp);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, signatureTexture);
-        signatureShader.setInt("uDiffMap", 0);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, signatureTexture);
+            signatureShader.setInt("uDiffMap", 0);
 
-        glBindVertexArray(signatureVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+            glBindVertexArray(signatureVAO);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+            glBindVertexArray(0);
+        }
+
+        if (passProfiler.isEnabled() && now - lastProfileReportTime >= 1.0) {
+            passProfiler.dump(std::cout);
+            if (occlusionCuller.isEnabled())
+                std::cout << "Occlusion culling: preskoceno objekata u frejmu: " << occlusionCuller.getSkippedCount() << std::endl;
+            lastProfileReportTime = now;
+        }
 
         // vracamo cull face i depth test na prethodno
         // nije potrebno ovde stavljati sobzirom da to vec radimo na pocetku render loop-a, ali sto da ne
         if (prevDepth) glEnable(GL_DEPTH_TEST);
         if (prevCull)  glEnable(GL_CULL_FACE);
 
+        // vreme koje je CPU proveo na ovom frejmu (bez cekanja na sledeci)
+        dynamicResolution.update(glfwGetTime() - now);
+
         glfwSwapBuffers(window);
-        glfwPollEvents();
     }
 
+    rideSimulation->stop();
+    // ceka nit za generisanje staze ako je jos u toku
+    delete trackRebuilder;
+
+    // konacno stanje sesije: pri snimanju se upisuje, pri reprodukciji se poredi sa snimljenim
+    int exitCode = 0;
+    if (sessionMode != SessionMode::LIVE) {
+        SessionResult result;
+        result.frames = sessionFrames;
+        result.ticks = rideSimulation->getTickCount();
+        result.t = rideSimulation->getT();
+        result.rideState = (int32_t)rideSimulation->getRideState();
+        result.yaw = yaw;
+        result.pitch = pitch;
+        result.cameraPos = cameraPos;
+        if (sessionMode == SessionMode::RECORD) {
+            sessionRecorder.close(result);
+        }
+        else {
+            double seconds = glfwGetTime() - sessionStartTime;
+            bool match = result == sessionReplay.getExpectedResult();
+            std::cout << "Reprodukcija sesije: " << sessionFrames << " frejmova za " << seconds << " s ("
+                << sessionFrames / std::max(seconds, 1e-9) << " fps), konacno stanje "
+                << (match ? "se poklapa" : "SE NE POKLAPA") << " sa snimkom" << std::endl;
+            sessionReplay.getExpectedResult().print("snimljeno");
+            result.print("reprodukovano");
+            if (!match)
+                exitCode = 5;
+        }
+    }
+
+    std::cout << "Simulacija: koraka " << rideSimulation->getTickCount()
+        << ", frejmova sa novim snapshot-om " << rideSimulation->getNewSnapshotFrames()
+        << ", frejmova sa ponovljenim snapshot-om " << rideSimulation->getReusedSnapshotFrames() << std::endl;
+    rideSimulation->getInputStats().print("voznja");
+    viewInputStats.print("kamera");
+    frameScheduler.printStats();
+    jobSystem.printStats();
+    commandReplayer.printStats();
+    if (renderOnDemandEnabled)
+        renderOnDemand.printStats();
+    if (passProfiler.isEnabled())
+        passProfiler.dump(std::cout);
     glfwTerminate();
-    return 0;
+    return exitCode;
 }
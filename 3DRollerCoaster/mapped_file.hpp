@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+    fajl mapiran u memoriju samo za citanje (Win32 CreateFileMapping / POSIX mmap):
+        - sadrzaj se ne kopira, stranice ucitava OS kad im se prvi put pristupi
+        - pokazivac vazi dok se fajl ne zatvori (close ili destruktor)
+*/
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    const uint8_t* data() const;
+    size_t size() const;
+
+private:
+    const uint8_t* view = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
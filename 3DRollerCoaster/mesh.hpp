@@ -10,6 +10,7 @@
 
 #include "shader.hpp"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 using namespace std;
@@ -35,17 +36,97 @@ public:
     vector<Vertex>       vertices;
     vector<unsigned int> indices;
     vector<Texture>      textures;
-    unsigned int VAO;
+    unsigned int VAO = 0;
+    // number of indices in the element buffer (also set for meshes uploaded without a CPU copy)
+    size_t indexCount = 0;
 
     // constructor
-    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures)
+    // (uploadNow = false lets the mesh be built on a worker thread; uploadToGPU is then called on the GL thread)
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures, bool uploadNow = true)
     {
         this->vertices = vertices;
         this->indices = indices;
         this->textures = textures;
 
         // now that we have all the required data, set the vertex buffers and its attribute pointers.
-        setupMesh();
+        if (uploadNow)
+            setupMesh();
+    }
+
+    // uploads vertex/index data that lives outside the mesh (e.g. a memory-mapped file) straight into
+    // the buffer objects; no CPU copy is kept, so vertices and indices stay empty
+    Mesh(const Vertex* vertexData, size_t vertexCount, const unsigned int* indexData, size_t indexCount, vector<Texture> textures)
+    {
+        this->textures = textures;
+        setupBuffers(vertexData, vertexCount, indexData, indexCount);
+    }
+
+    // creates the buffer objects for a mesh that was constructed without uploading
+    void uploadToGPU()
+    {
+        if (VAO == 0)
+            setupMesh();
+    }
+
+    // incremental upload, so a big mesh can be spread over several frames:
+    // beginUpload allocates the buffers, uploadChunk copies at most maxBytes and returns how many bytes it copied
+    void beginUpload()
+    {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+        uploadedBytes = 0;
+        indexCount = indices.size();
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), NULL, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), NULL, GL_STATIC_DRAW);
+        setupAttributes();
+        glBindVertexArray(0);
+    }
+
+    size_t uploadChunk(size_t maxBytes)
+    {
+        size_t size = 0;
+        size_t vertexBytes = vertices.size() * sizeof(Vertex);
+        size_t indexBytes = indices.size() * sizeof(unsigned int);
+        // vertices first, then indices
+        if (uploadedBytes < vertexBytes)
+        {
+            size = std::min(maxBytes, vertexBytes - uploadedBytes);
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferSubData(GL_ARRAY_BUFFER, uploadedBytes, size, (const char*)vertices.data() + uploadedBytes);
+            uploadedBytes += size;
+        }
+        else if (uploadedBytes < vertexBytes + indexBytes)
+        {
+            size_t offset = uploadedBytes - vertexBytes;
+            size = std::min(maxBytes, indexBytes - offset);
+            // the element buffer binding is VAO state, so bind the VAO while copying
+            glBindVertexArray(VAO);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, (const char*)indices.data() + offset);
+            glBindVertexArray(0);
+            uploadedBytes += size;
+        }
+        return size;
+    }
+
+    bool isUploaded() const
+    {
+        return VAO != 0 && uploadedBytes >= vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int);
+    }
+
+    // deletes the buffer objects (meshes are copied by value, so this is never done implicitly)
+    void release()
+    {
+        if (VAO == 0)
+            return;
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
     }
 
     // render the mesh
@@ -74,7 +155,7 @@ public:
 
         // draw mesh
         glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indexCount), GL_UNSIGNED_INT, 0);
         glBindVertexArray(0);
 
         // always good practice to set everything back to defaults once configured.
@@ -83,11 +164,18 @@ public:
 
 private:
     // render data 
-    unsigned int VBO, EBO;
+    unsigned int VBO = 0, EBO = 0;
+    size_t uploadedBytes = 0;
 
     // initializes all the buffer objects/arrays
     void setupMesh()
     {
+        setupBuffers(vertices.data(), vertices.size(), indices.data(), indices.size());
+    }
+
+    void setupBuffers(const Vertex* vertexData, size_t vertexCount, const unsigned int* indexData, size_t indexCount)
+    {
+        this->indexCount = indexCount;
         // create buffers/arrays
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
@@ -99,12 +187,17 @@ private:
         // A great thing about structs is that their memory layout is sequential for all its items.
         // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
         // again translates to 3/2 floats which translates to a byte array.
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertexData, GL_STATIC_DRAW);
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indexData, GL_STATIC_DRAW);
+
+        setupAttributes();
+    }
 
-        // set the vertex attribute pointers
+    // set the vertex attribute pointers (VAO and VBO must be bound)
+    void setupAttributes()
+    {
         // vertex Positions
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
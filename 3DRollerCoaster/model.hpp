@@ -24,6 +24,14 @@
 using namespace std;
 
 unsigned int TextureFromFile(const char* path, const string& directory, bool gamma = false);
+unsigned int TextureFromData(unsigned char* data, int width, int height, int nrComponents);
+
+// texture decoded on a worker thread, waiting to be uploaded on the GL thread
+struct PendingImage {
+    string path;
+    unsigned char* data;
+    int width, height, nrComponents;
+};
 
 class Model
 {
@@ -38,7 +46,9 @@ public:
     glm::vec3 maxVertex;
 
     // constructor, expects a filepath to a 3D model.
-    Model(string const& path, bool gamma = false) : gammaCorrection(gamma)
+    // with uploadNow = false only the CPU work is done (Assimp import, mesh data, image decoding), so the
+    // model can be loaded on a worker thread; uploadToGPU must then be called on the GL thread before drawing.
+    Model(string const& path, bool gamma = false, bool uploadNow = true) : gammaCorrection(gamma), deferUpload(!uploadNow)
     {
         loadModel(path);
         minVertex = glm::vec3(FLT_MAX);
@@ -54,11 +64,36 @@ public:
     }
 
 
+    // creates GL textures and buffers for a model loaded with uploadNow = false
+    void uploadToGPU()
+    {
+        for (PendingImage& image : pendingImages)
+        {
+            unsigned int id = TextureFromData(image.data, image.width, image.height, image.nrComponents);
+            stbi_image_free(image.data);
+            for (Texture& texture : textures_loaded)
+                if (texture.path == image.path)
+                    texture.id = id;
+            for (Mesh& mesh : meshes)
+                for (Texture& texture : mesh.textures)
+                    if (texture.path == image.path)
+                        texture.id = id;
+        }
+        pendingImages.clear();
+
+        for (Mesh& mesh : meshes)
+            mesh.uploadToGPU();
+        deferUpload = false;
+    }
+
     glm::vec3 getMinVertex() const { return minVertex; }
     glm::vec3 getMaxVertex() const { return maxVertex; }
     float getHeight() const { return maxVertex.y - minVertex.y; }
 
 private:
+    bool deferUpload;
+    vector<PendingImage> pendingImages;
+
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
     void loadModel(string const& path)
     {
@@ -160,7 +195,7 @@ private:
         textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
 
         // return a mesh object created from the extracted mesh data
-        return Mesh(vertices, indices, textures);
+        return Mesh(vertices, indices, textures, !deferUpload);
     }
 
     // checks all material textures of a given type and loads the textures if they're not loaded yet.
@@ -186,7 +221,20 @@ private:
             if (!skip)
             {   // if texture hasn't been loaded already, load it
                 Texture texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
+                if (deferUpload)
+                {   // decode now, the GL texture is created in uploadToGPU
+                    texture.id = 0;
+                    PendingImage image;
+                    image.path = str.C_Str();
+                    string filename = this->directory + '/' + image.path;
+                    image.data = stbi_load(filename.c_str(), &image.width, &image.height, &image.nrComponents, 0);
+                    if (image.data)
+                        pendingImages.push_back(image);
+                    else
+                        std::cout << "Texture failed to load at path: " << image.path << std::endl;
+                }
+                else
+                    texture.id = TextureFromFile(str.C_Str(), this->directory);
                 texture.type = typeName;
                 texture.path = str.C_Str();
                 textures.push_back(texture);
@@ -221,38 +269,43 @@ inline unsigned int TextureFromFile(const char* path, const string& directory, b
     string filename = string(path);
     filename = directory + '/' + filename;
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
     int width, height, nrComponents;
     unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
     if (data)
     {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    }
-    else
-    {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
+        unsigned int textureID = TextureFromData(data, width, height, nrComponents);
         stbi_image_free(data);
+        return textureID;
     }
 
+    std::cout << "Texture failed to load at path: " << path << std::endl;
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    return textureID;
+}
+
+inline unsigned int TextureFromData(unsigned char* data, int width, int height, int nrComponents)
+{
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+
+    GLenum format;
+    if (nrComponents == 1)
+        format = GL_RED;
+    else if (nrComponents == 3)
+        format = GL_RGB;
+    else if (nrComponents == 4)
+        format = GL_RGBA;
+
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
     return textureID;
 }
 #endif
@@ -0,0 +1,8 @@
+#version 330 core
+out vec4 FragColor;
+
+void main()
+{
+    // boja se ne upisuje (color mask je iskljucen), bitno je samo da li je neki fragment prosao depth test
+    FragColor = vec4(1.0);
+}
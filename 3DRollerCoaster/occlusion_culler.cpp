@@ -0,0 +1,142 @@
+#include "occlusion_culler.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+OcclusionCuller::OcclusionCuller(int maxObjects) :
+maxObjects(maxObjects),
+visible(maxObjects, true),
+shader("occlusion.vert", "occlusion.frag")
+{
+    for (int i = 0; i < 2; i++) {
+        queries[i].resize(maxObjects);
+        queryIssued[i].assign(maxObjects, false);
+        glGenQueries(maxObjects, queries[i].data());
+    }
+    generateBox();
+}
+
+OcclusionCuller::~OcclusionCuller() {
+    for (int i = 0; i < 2; i++)
+        glDeleteQueries(maxObjects, queries[i].data());
+    glDeleteVertexArrays(1, &boxVAO);
+    glDeleteBuffers(1, &boxVBO);
+    glDeleteBuffers(1, &boxEBO);
+    glDeleteProgram(shader.ID);
+}
+
+void OcclusionCuller::setEnabled(bool enabled) {
+    this->enabled = enabled;
+    // kad se mod ponovo ukljuci ne oslanjamo se na stare rezultate
+    visible.assign(maxObjects, true);
+    queryIssued[0].assign(maxObjects, false);
+    queryIssued[1].assign(maxObjects, false);
+}
+
+bool OcclusionCuller::isEnabled() const {
+    return enabled;
+}
+
+void OcclusionCuller::generateBox() {
+    // jedinicna kocka [0,1]^3, skalira se na bounding box objekta preko model matrice
+    float boxVertices[] = {
+        0, 0, 0,   1, 0, 0,   1, 1, 0,   0, 1, 0,
+        0, 0, 1,   1, 0, 1,   1, 1, 1,   0, 1, 1
+    };
+    unsigned int boxIndices[] = {
+        0, 2, 1,   0, 3, 2,     // back
+        4, 5, 6,   4, 6, 7,     // front
+        0, 4, 7,   0, 7, 3,     // left
+        1, 2, 6,   1, 6, 5,     // right
+        3, 7, 6,   3, 6, 2,     // top
+        0, 1, 5,   0, 5, 4      // bottom
+    };
+
+    glGenVertexArrays(1, &boxVAO);
+    glGenBuffers(1, &boxVBO);
+    glGenBuffers(1, &boxEBO);
+
+    glBindVertexArray(boxVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, boxVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(boxVertices), boxVertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, boxEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(boxIndices), boxIndices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+}
+
+void OcclusionCuller::beginFrame() {
+    skippedCount = 0;
+    boxes.clear();
+    if (!enabled) return;
+
+    // upiti poslati u prethodnom frejmu
+    int prev = (frameIndex + 1) % 2;
+    for (int id = 0; id < maxObjects; id++) {
+        if (!queryIssued[prev][id]) {
+            // za objekat nije bilo upita (npr. putnik nije u kolima) - pretpostavljamo da je vidljiv
+            visible[id] = true;
+            continue;
+        }
+
+        GLuint available = 0;
+        glGetQueryObjectuiv(queries[prev][id], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint anySamples = 0;
+            glGetQueryObjectuiv(queries[prev][id], GL_QUERY_RESULT, &anySamples);
+            visible[id] = anySamples != 0;
+        }
+        else {
+            // rezultat jos nije stigao - ne cekamo GPU vec crtamo objekat
+            visible[id] = true;
+        }
+        queryIssued[prev][id] = false;
+    }
+}
+
+bool OcclusionCuller::isVisible(int id) const {
+    return !enabled || visible[id];
+}
+
+void OcclusionCuller::markSkipped() {
+    skippedCount++;
+}
+
+void OcclusionCuller::addBox(int id, const glm::vec3& minV, const glm::vec3& maxV, const glm::mat4& model) {
+    if (!enabled) return;
+
+    glm::mat4 boxModel = glm::translate(glm::mat4(1.0f), minV);
+    boxModel = glm::scale(boxModel, maxV - minV);
+    boxes.push_back({ id, model * boxModel });
+}
+
+void OcclusionCuller::issueQueries(const glm::mat4& view, const glm::mat4& projection) {
+    if (!enabled) return;
+
+    // box-ovi se ne vide i ne smeju da menjaju Z bafer, a moramo ih videti i iznutra (kamera u kolima)
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    GLboolean cullWasOn = glIsEnabled(GL_CULL_FACE);
+    glDisable(GL_CULL_FACE);
+
+    shader.use();
+    glBindVertexArray(boxVAO);
+    glm::mat4 viewProjection = projection * view;
+    for (const Box& box : boxes) {
+        shader.setMat4("uMVP", viewProjection * box.model);
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, queries[frameIndex][box.id]);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+        queryIssued[frameIndex][box.id] = true;
+    }
+    glBindVertexArray(0);
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+    if (cullWasOn) glEnable(GL_CULL_FACE);
+
+    frameIndex = (frameIndex + 1) % 2;
+}
+
+int OcclusionCuller::getSkippedCount() const {
+    return skippedCount;
+}
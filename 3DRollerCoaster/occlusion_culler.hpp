@@ -0,0 +1,56 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "shader.hpp"
+
+/*
+    occlusion culling preko hardverskih upita (GL_ANY_SAMPLES_PASSED):
+        - za svaki objekat se posle crtanja okludera (ground, staza, kola) crta jeftin bounding box
+          sa iskljucenim upisom boje i dubine i pita se da li je bar jedan fragment prosao depth test
+        - rezultat se cita tek sledeceg frejma (i to samo ako je vec dostupan), pa se pipeline nikad ne zaustavlja
+        - objekat za koji nemamo rezultat se smatra vidljivim
+*/
+class OcclusionCuller {
+public:
+    OcclusionCuller(int maxObjects);
+    ~OcclusionCuller();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // cita rezultate upita iz prethodnog frejma i resetuje brojac preskocenih objekata
+    void beginFrame();
+    // da li objekat treba crtati u ovom frejmu
+    bool isVisible(int id) const;
+    // objekat nije nacrtan (samo za statistiku)
+    void markSkipped();
+    // dodaje bounding box objekta (u lokalnim koordinatama modela) za upit u ovom frejmu
+    void addBox(int id, const glm::vec3& minV, const glm::vec3& maxV, const glm::mat4& model);
+    // crta sve bounding box-ove iz ovog frejma unutar upita
+    void issueQueries(const glm::mat4& view, const glm::mat4& projection);
+
+    int getSkippedCount() const;
+
+private:
+    struct Box {
+        int id;
+        glm::mat4 model;        // jedinicna kocka -> bounding box u svetu
+    };
+
+    bool enabled = true;
+    int maxObjects;
+    int frameIndex = 0;
+    int skippedCount = 0;
+
+    // dva seta upita (parni i neparni frejm) da ne bismo citali upit koji smo upravo poslali
+    std::vector<GLuint> queries[2];
+    std::vector<bool> queryIssued[2];
+    std::vector<bool> visible;
+    std::vector<Box> boxes;
+
+    Shader shader;
+    unsigned int boxVAO, boxVBO, boxEBO;
+
+    void generateBox();
+};
@@ -0,0 +1,199 @@
+#include "pass_profiler.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+void PassProfiler::RollingStat::add(double value) {
+    values[next] = value;
+    next = (next + 1) % (int)values.size();
+    count = std::min(count + 1, (int)values.size());
+    total++;
+}
+
+double PassProfiler::RollingStat::average() const {
+    if (count == 0) return 0.0;
+    double sum = 0.0;
+    for (int i = 0; i < count; i++)
+        sum += values[i];
+    return sum / count;
+}
+
+double PassProfiler::RollingStat::maximum() const {
+    double result = 0.0;
+    for (int i = 0; i < count; i++)
+        result = std::max(result, values[i]);
+    return result;
+}
+
+PassProfiler::PassProfiler(int historyFrames) :
+historyFrames(std::max(historyFrames, 1))
+{
+}
+
+PassProfiler::~PassProfiler() {
+    for (FrameSlot& slot : slots)
+        if (!slot.queries.empty())
+            glDeleteQueries((GLsizei)slot.queries.size(), slot.queries.data());
+}
+
+void PassProfiler::setEnabled(bool enabled) {
+    if (this->enabled == enabled) return;
+    this->enabled = enabled;
+    // upiti iz vremena pre gasenja vise nisu zanimljivi
+    for (FrameSlot& slot : slots) {
+        slot.samples.clear();
+        slot.usedQueries = 0;
+    }
+    openPasses.clear();
+    frameStarted = false;
+}
+
+bool PassProfiler::isEnabled() const {
+    return enabled;
+}
+
+int PassProfiler::findPass(const char* name) {
+    for (size_t i = 0; i < passes.size(); i++)
+        if (passes[i].name == name)
+            return (int)i;
+
+    Pass pass;
+    pass.name = name;
+    pass.cpu.values.resize(historyFrames);
+    pass.gpu.values.resize(historyFrames);
+    passes.push_back(pass);
+    return (int)passes.size() - 1;
+}
+
+GLuint PassProfiler::nextQuery(FrameSlot& slot) {
+    if (slot.usedQueries == (int)slot.queries.size()) {
+        // pul se duplira (upiti se nikad ne brisu dok profiler postoji)
+        size_t oldSize = slot.queries.size();
+        size_t newSize = std::max<size_t>(16, oldSize * 2);
+        slot.queries.resize(newSize);
+        glGenQueries((GLsizei)(newSize - oldSize), slot.queries.data() + oldSize);
+    }
+    return slot.queries[slot.usedQueries++];
+}
+
+void PassProfiler::collectSlot(FrameSlot& slot) {
+    if (slot.samples.empty())
+        return;
+
+    // ako poslednji upit nije spreman ni posle FRAME_LATENCY frejmova - ceo frejm se preskace
+    GLuint available = 0;
+    glGetQueryObjectuiv(slot.samples.back().endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        droppedGpuFrames++;
+    }
+    else {
+        std::map<int, double> frameGpuMs;
+        for (const GpuSample& sample : slot.samples) {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(sample.beginQuery, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(sample.endQuery, GL_QUERY_RESULT, &end);
+            frameGpuMs[sample.pass] += (end - begin) / 1000000.0;
+        }
+        for (const auto& entry : frameGpuMs)
+            passes[entry.first].gpu.add(entry.second);
+    }
+    slot.samples.clear();
+    slot.usedQueries = 0;
+}
+
+void PassProfiler::finishCpuFrame() {
+    for (Pass& pass : passes) {
+        if (!pass.usedThisFrame) continue;
+        pass.cpu.add(pass.frameCpuMs);
+        pass.frameCpuMs = 0.0;
+        pass.usedThisFrame = false;
+    }
+}
+
+void PassProfiler::beginFrame() {
+    if (!enabled) return;
+    if (frameStarted) {
+        finishCpuFrame();
+        currentSlot = (currentSlot + 1) % FRAME_LATENCY;
+    }
+    openPasses.clear();
+    // ovaj slot je poslednji put koriscen pre FRAME_LATENCY frejmova
+    collectSlot(slots[currentSlot]);
+    frameStarted = true;
+}
+
+void PassProfiler::beginPass(const char* name) {
+    if (!enabled || !frameStarted) return;
+
+    FrameSlot& slot = slots[currentSlot];
+    OpenPass open;
+    open.pass = findPass(name);
+    open.sample = (int)slot.samples.size();
+
+    GpuSample sample;
+    sample.pass = open.pass;
+    sample.beginQuery = nextQuery(slot);
+    sample.endQuery = nextQuery(slot);
+    glQueryCounter(sample.beginQuery, GL_TIMESTAMP);
+    slot.samples.push_back(sample);
+
+    open.start = Clock::now();
+    openPasses.push_back(open);
+}
+
+void PassProfiler::endPass() {
+    if (!enabled || openPasses.empty()) return;
+
+    OpenPass open = openPasses.back();
+    openPasses.pop_back();
+
+    Pass& pass = passes[open.pass];
+    pass.frameCpuMs += std::chrono::duration<double, std::milli>(Clock::now() - open.start).count();
+    pass.usedThisFrame = true;
+
+    glQueryCounter(slots[currentSlot].samples[open.sample].endQuery, GL_TIMESTAMP);
+}
+
+std::vector<PassProfiler::PassStats> PassProfiler::getStats() const {
+    std::vector<PassStats> result;
+    for (const Pass& pass : passes) {
+        PassStats stats;
+        stats.name = pass.name;
+        stats.cpuAverageMs = pass.cpu.average();
+        stats.cpuMaxMs = pass.cpu.maximum();
+        stats.gpuAverageMs = pass.gpu.average();
+        stats.gpuMaxMs = pass.gpu.maximum();
+        stats.cpuSamples = pass.cpu.total;
+        stats.gpuSamples = pass.gpu.total;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+bool PassProfiler::getStats(const std::string& name, PassStats& stats) const {
+    for (const PassStats& candidate : getStats()) {
+        if (candidate.name == name) {
+            stats = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+long long PassProfiler::getDroppedGpuFrames() const {
+    return droppedGpuFrames;
+}
+
+void PassProfiler::dump(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+    out << "Prolazi (poslednjih " << historyFrames << " frejmova, ms)   CPU prosek / max   GPU prosek / max\n";
+    for (const PassStats& stats : getStats()) {
+        out << "  " << std::left << std::setw(12) << stats.name << std::right
+            << std::setw(10) << stats.cpuAverageMs << " / " << std::setw(8) << stats.cpuMaxMs
+            << std::setw(10) << stats.gpuAverageMs << " / " << std::setw(8) << stats.gpuMaxMs << "\n";
+    }
+    if (droppedGpuFrames > 0)
+        out << "  GPU rezultati nisu stigli na vreme za " << droppedGpuFrames << " frejmova\n";
+    out.flags(flags);
+}
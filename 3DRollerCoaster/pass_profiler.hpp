@@ -0,0 +1,109 @@
+#pragma once
+#include <GL/glew.h>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+    merenje CPU i GPU vremena po prolazu (ground, staza, kola, putnici...):
+        - GPU: par GL_TIMESTAMP upita (glQueryCounter) oko prolaza; GL_TIME_ELAPSED se ne moze ugnjezditi,
+          a dinamicka rezolucija vec meri celu scenu njime
+        - upiti su u prstenu od FRAME_LATENCY frejmova i citaju se tek kad se slot ponovo koristi;
+          ako rezultat ni tada nije spreman, uzorak se odbacuje (nikad se ne ceka na GPU)
+        - isti prolaz moze da se pozove vise puta u frejmu (npr. pojas za svakog putnika), vremena se sabiraju
+        - za svaki prolaz se cuva prosek i maksimum poslednjih historyFrames frejmova
+*/
+class PassProfiler {
+public:
+    static const int FRAME_LATENCY = 4;
+
+    explicit PassProfiler(int historyFrames = 120);
+    ~PassProfiler();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // na pocetku frejma: zavrsava CPU vremena prethodnog frejma i cita GPU rezultate starog slota
+    void beginFrame();
+    void beginPass(const char* name);
+    void endPass();
+
+    struct PassStats {
+        std::string name;
+        double cpuAverageMs = 0.0, cpuMaxMs = 0.0;
+        double gpuAverageMs = 0.0, gpuMaxMs = 0.0;
+        long long cpuSamples = 0, gpuSamples = 0;
+    };
+    std::vector<PassStats> getStats() const;
+    bool getStats(const std::string& name, PassStats& stats) const;
+    long long getDroppedGpuFrames() const;
+    void dump(std::ostream& out) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // prosek i maksimum poslednjih N vrednosti
+    struct RollingStat {
+        std::vector<double> values;
+        int next = 0;
+        int count = 0;
+        long long total = 0;
+        void add(double value);
+        double average() const;
+        double maximum() const;
+    };
+
+    struct Pass {
+        std::string name;
+        RollingStat cpu;
+        RollingStat gpu;
+        double frameCpuMs = 0.0;    // zbir u tekucem frejmu
+        bool usedThisFrame = false;
+    };
+
+    struct GpuSample {
+        int pass;
+        GLuint beginQuery;
+        GLuint endQuery;
+    };
+
+    struct FrameSlot {
+        std::vector<GLuint> queries;        // pul upita za ovaj slot (raste po potrebi)
+        std::vector<GpuSample> samples;
+        int usedQueries = 0;
+    };
+
+    struct OpenPass {
+        int pass;
+        Clock::time_point start;
+        int sample;     // indeks u samples tekuceg slota
+    };
+
+    bool enabled = false;
+    int historyFrames;
+    std::vector<Pass> passes;
+    FrameSlot slots[FRAME_LATENCY];
+    int currentSlot = 0;
+    bool frameStarted = false;
+    std::vector<OpenPass> openPasses;
+    long long droppedGpuFrames = 0;
+
+    int findPass(const char* name);
+    GLuint nextQuery(FrameSlot& slot);
+    void collectSlot(FrameSlot& slot);
+    void finishCpuFrame();
+};
+
+// prolaz traje do kraja bloka
+class ProfileScope {
+public:
+    ProfileScope(PassProfiler& profiler, const char* name) : profiler(profiler) { profiler.beginPass(name); }
+    ~ProfileScope() { profiler.endPass(); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    PassProfiler& profiler;
+};
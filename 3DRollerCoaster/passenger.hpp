@@ -0,0 +1,36 @@
+#ifndef PASSENGER_H
+#define PASSENGER_H
+
+// stanje putnika bez modela - dovoljno za logiku voznje (i za headless simulaciju bez OpenGL-a)
+struct Passenger {
+    int seatIndex;
+    bool isActive;
+    bool isSick;
+    bool isBeltOn;
+
+    explicit Passenger(int seat)
+        : seatIndex(seat), isActive(false), isSick(false), isBeltOn(false) {}
+
+    void sitDown() {
+        isActive = true;
+    }
+
+    void leave() {
+        isActive = false;
+        isSick = false;
+    }
+
+    void putBeltOn() {
+        isBeltOn = true;
+    }
+
+    void putBeltOff() {
+        isBeltOn = false;
+    }
+
+    void becomeSick() {
+        isSick = true;
+    }
+};
+
+#endif
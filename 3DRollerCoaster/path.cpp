@@ -1,6 +1,10 @@
 #include "path.hpp"
+#include "simd_math.hpp"
 #include <glm/gtc/constants.hpp>
 #include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
 
 Path::Path(
     float length,
@@ -8,7 +12,8 @@ Path::Path(
     float baseHeight,
     float amplitude,
     int hills,
-    glm::vec3 origin = glm::vec3(0.0f)
+    glm::vec3 origin,
+    float bankAngle
 )
     : length(length),
     returnOffsetZ(returnOffsetZ),
@@ -16,8 +21,139 @@ Path::Path(
     baseHeight(baseHeight),
     amplitude(amplitude),
     hills(hills),
-    origin(origin)
+    origin(origin),
+    bankAngle(bankAngle)
 {
+    buildArcLengthTable();
+    buildFrameTable();
+}
+
+Path::Path(const PathParams& params)
+    : length(params.length),
+    returnOffsetZ(params.returnOffsetZ),
+    turnRadius(params.returnOffsetZ * 0.5f),
+    baseHeight(params.baseHeight),
+    amplitude(params.amplitude),
+    hills(params.hills),
+    origin(params.origin),
+    bankAngle(params.bankAngle),
+    controlPoints(params.controlPoints)
+{
+    if (!controlPoints.empty())
+        buildSpline();
+    buildArcLengthTable();
+    buildFrameTable();
+}
+
+Path::Path(const PathParams& params, const PathTables& tables)
+    : length(params.length),
+    returnOffsetZ(params.returnOffsetZ),
+    turnRadius(params.returnOffsetZ * 0.5f),
+    baseHeight(params.baseHeight),
+    amplitude(params.amplitude),
+    hills(params.hills),
+    origin(params.origin),
+    bankAngle(params.bankAngle),
+    controlPoints(params.controlPoints)
+{
+    // koeficijenti splajna su mali (4 vektora po tacki), racunaju se ponovo
+    if (!controlPoints.empty())
+        buildSpline();
+
+    arcLengthSamples = tables.arcLengthSamples;
+    arcLengths.assign(tables.arcLengths, tables.arcLengths + arcLengthSamples + 1);
+    tAtDistance.assign(tables.tAtDistance, tables.tAtDistance + arcLengthSamples + 1);
+    totalLength = arcLengths[arcLengthSamples];
+
+    frameSamples = tables.frameSamples;
+    posePositions.assign(tables.posePositions, tables.posePositions + frameSamples + 1);
+    poseOrientations.assign(tables.poseOrientations, tables.poseOrientations + frameSamples + 1);
+}
+
+PathParams Path::getParams() const
+{
+    PathParams params;
+    params.length = length;
+    params.returnOffsetZ = returnOffsetZ;
+    params.baseHeight = baseHeight;
+    params.amplitude = amplitude;
+    params.hills = hills;
+    params.origin = origin;
+    params.bankAngle = bankAngle;
+    params.controlPoints = controlPoints;
+    return params;
+}
+
+PathTables Path::getTables() const
+{
+    PathTables tables;
+    tables.arcLengths = arcLengths.data();
+    tables.tAtDistance = tAtDistance.data();
+    tables.arcLengthSamples = arcLengthSamples;
+    tables.posePositions = posePositions.data();
+    tables.poseOrientations = poseOrientations.data();
+    tables.frameSamples = frameSamples;
+    return tables;
+}
+
+bool Path::isSpline() const
+{
+    return !splineCoefficients.empty();
+}
+
+bool Path::loadControlPoints(const std::string& file, std::vector<TrackControlPoint>& points)
+{
+    std::ifstream in(file);
+    if (!in) {
+        std::cout << "Staza: ne moze da se otvori " << file << std::endl;
+        return false;
+    }
+
+    points.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        std::istringstream fields(line);
+        // preskacu se samo prazni redovi (ili samo komentar)
+        if ((fields >> std::ws).eof())
+            continue;
+        TrackControlPoint point;
+        if (!(fields >> point.position.x >> point.position.y >> point.position.z)) {
+            std::cout << "Staza: " << file << ":" << lineNumber << " ocekivano \"x y z [nagib]\"" << std::endl;
+            return false;
+        }
+        // nagib je opcioni, ali posle njega ne sme da ostane nista (npr. "4 1 0 15x" ili "4 1 0 foo")
+        std::string rest;
+        if (!(fields >> point.bank)) {
+            fields.clear();
+            point.bank = 0.0f;
+        }
+        if (fields >> rest) {
+            std::cout << "Staza: " << file << ":" << lineNumber << " visak \"" << rest << "\" posle \"x y z [nagib]\"" << std::endl;
+            return false;
+        }
+        // ista tacka dva puta zaredom daje segment nulte duzine (tangenta i okvir tu nisu definisani)
+        if (!points.empty() && points.back().position == point.position) {
+            std::cout << "Staza: " << file << ":" << lineNumber << " ponavlja prethodnu kontrolnu tacku" << std::endl;
+            return false;
+        }
+        points.push_back(point);
+    }
+
+    if (points.size() < 4) {
+        std::cout << "Staza: " << file << " ima " << points.size() << " kontrolnih tacaka, potrebno je bar 4" << std::endl;
+        return false;
+    }
+    // staza je zatvorena: poslednja tacka se spaja sa prvom, pa ni one ne smeju da budu iste
+    if (points.back().position == points.front().position) {
+        std::cout << "Staza: " << file << " poslednja kontrolna tacka je ista kao prva (staza se sama zatvara)" << std::endl;
+        return false;
+    }
+    return true;
 }
 
 // ================= PATH =================
@@ -29,7 +165,10 @@ glm::vec3 Path::getPoint(float t) const
         - turnTrack: U-turn putanja koja spaja kraj forwardTrack-a i pocetak returnTrack-a
         - returnTrack: drugi deo putanje koji "ide nazad", jednostavna ide do x,y pocetka i nalazi se na +returnOffsetZ u odnosu na forwardTrack
         - turnTrackBack: U-turn putanja koja spaja kraj returnTrack-a i pocetak forwardTrack-a
+    staza iz fajla (isSpline) umesto toga ide kroz svoje kontrolne tacke
     */
+    if (isSpline())
+        return splinePoint(t);
     if (t < 0.40f) {
         return forwardTrack(t / 0.40f);
     }
@@ -44,12 +183,349 @@ glm::vec3 Path::getPoint(float t) const
     }
 }
 
+glm::vec3 Path::getDerivative(float t) const
+{
+    // segment sa udelom w u t-u ima lokalni parametar u = (t - pocetak) / w, pa je dP/dt = dP/du / w
+    if (isSpline())
+        return splineDerivative(t);
+    if (t < 0.40f)
+        return forwardTrackDerivative(t / 0.40f) * (1.0f / 0.40f);
+    else if (t < 0.50f)
+        return turnTrackDerivative((t - 0.40f) / 0.10f) * (1.0f / 0.10f);
+    else if (t < 0.90f)
+        return returnTrackDerivative((t - 0.50f) / 0.40f) * (1.0f / 0.40f);
+    else
+        return turnTrackBackDerivative((t - 0.90f) / 0.10f) * (1.0f / 0.10f);
+}
+
+glm::vec3 Path::getSecondDerivative(float t) const
+{
+    // d2P/dt2 = d2P/du2 / w^2 (povratni deo je prav)
+    if (isSpline())
+        return splineSecondDerivative(t);
+    if (t < 0.40f)
+        return forwardTrackSecondDerivative(t / 0.40f) * (1.0f / (0.40f * 0.40f));
+    else if (t < 0.50f)
+        return turnTrackSecondDerivative((t - 0.40f) / 0.10f) * (1.0f / (0.10f * 0.10f));
+    else if (t < 0.90f)
+        return glm::vec3(0.0f);
+    else
+        return turnTrackBackSecondDerivative((t - 0.90f) / 0.10f) * (1.0f / (0.10f * 0.10f));
+}
+
 glm::vec3 Path::getTangent(float t) const
 {
-    float eps = 0.001f;
-    glm::vec3 p1 = getPoint(t);
-    glm::vec3 p2 = getPoint(std::min(t + eps, 1.0f));
-    return glm::normalize(p2 - p1);
+    return glm::normalize(getDerivative(t));
+}
+
+float Path::getCurvature(float t) const
+{
+    glm::vec3 d1 = getDerivative(t);
+    glm::vec3 d2 = getSecondDerivative(t);
+    float speed = glm::length(d1);
+    return glm::length(glm::cross(d1, d2)) / (speed * speed * speed);
+}
+
+PathFrame Path::getFrame(float t) const
+{
+    return makeFrame(getPoint(t), getTangent(t), getOrientation(t));
+}
+
+PathFrame Path::makeFrame(const glm::vec3& position, const glm::vec3& tangent, const glm::quat& orientation)
+{
+    PathFrame frame;
+    frame.position = position;
+    frame.tangent = tangent;
+    glm::vec3 normal = orientation * glm::vec3(1.0f, 0.0f, 0.0f);
+    frame.normal = glm::normalize(normal - tangent * glm::dot(normal, tangent));
+    frame.binormal = glm::cross(tangent, frame.normal);
+    return frame;
+}
+
+// ================= NIZ PARAMETARA =================
+void Path::evaluateBatch(const float* t, int count, glm::vec3* points, glm::vec3* derivatives) const
+{
+    /*
+        niz se deli na uzastopne t-ove iz istog segmenta (potrosaci salju rastuce t-ove, pa su to dugi opsezi),
+        a svaki opseg se racuna petljom za taj segment bez grananja: po 4 ugla, sin/cos jednom SIMD operacijom
+        (simd_math.hpp), pa tacke i izvodi - formule su iste kao u getPoint i get*Derivative
+    */
+    if (isSpline()) {
+        // polinom po segmentu nema sin/cos, pa nema ni sta da se grupise
+        for (int i = 0; i < count; i++) {
+            if (points)
+                points[i] = splinePoint(t[i]);
+            if (derivatives)
+                derivatives[i] = splineDerivative(t[i]);
+        }
+        return;
+    }
+
+    const float pi = glm::pi<float>();
+    const float hillK = 2.0f * hills * pi;      // ugao brda po t2
+    auto segmentOf = [](float tl) { return tl < 0.40f ? 0 : tl < 0.50f ? 1 : tl < 0.90f ? 2 : 3; };
+
+    int begin = 0;
+    while (begin < count) {
+        int segment = segmentOf(t[begin]);
+        int end = begin + 1;
+        while (end < count && segmentOf(t[end]) == segment)
+            end++;
+
+        for (int base = begin; base < end; base += 4) {
+            int n = std::min(4, end - base);
+            float u[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            float angle[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            float sn[4], cs[4];
+
+            if (segment == 0) {
+                for (int lane = 0; lane < n; lane++) {
+                    u[lane] = t[base + lane] / 0.40f;
+                    angle[lane] = hillK * ((u[lane] - 0.2f) / 0.8f) - glm::half_pi<float>();
+                }
+                sincos4(angle, sn, cs);
+                for (int lane = 0; lane < n; lane++) {
+                    // ravan deo pre brda
+                    bool hill = u[lane] >= 0.2f;
+                    if (points)
+                        points[base + lane] = origin + glm::vec3(u[lane] * length,
+                            hill ? baseHeight + amplitude * (1.0f + sn[lane]) : baseHeight, 0.0f);
+                    if (derivatives)
+                        derivatives[base + lane] = glm::vec3(length / 0.40f,
+                            hill ? amplitude * (hillK / 0.8f) * cs[lane] / 0.40f : 0.0f, 0.0f);
+                }
+            }
+            else if (segment == 2) {
+                for (int lane = 0; lane < n; lane++) {
+                    float ul = (t[base + lane] - 0.50f) / 0.40f;
+                    if (points)
+                        points[base + lane] = origin + glm::vec3(length * (1.0f - ul), baseHeight, returnOffsetZ);
+                    if (derivatives)
+                        derivatives[base + lane] = glm::vec3(-length / 0.40f, 0.0f, 0.0f);
+                }
+            }
+            else {
+                // okretnice su iste do na smer: turnTrackBack je turnTrack preslikan oko pocetka i pomeren za returnOffsetZ
+                float start = segment == 1 ? 0.40f : 0.90f;
+                float side = segment == 1 ? 1.0f : -1.0f;
+                glm::vec3 center = segment == 1 ? glm::vec3(length, baseHeight, 0.0f) : glm::vec3(0.0f, baseHeight, returnOffsetZ);
+                for (int lane = 0; lane < n; lane++)
+                    angle[lane] = (t[base + lane] - start) / 0.10f * pi;
+                sincos4(angle, sn, cs);
+                for (int lane = 0; lane < n; lane++) {
+                    if (points)
+                        points[base + lane] = origin + center +
+                            side * glm::vec3(turnRadius * sn[lane], 0.0f, turnRadius * (1.0f - cs[lane]));
+                    if (derivatives)
+                        derivatives[base + lane] = side * (turnRadius * pi / 0.10f) * glm::vec3(cs[lane], 0.0f, sn[lane]);
+                }
+            }
+        }
+        begin = end;
+    }
+}
+
+void Path::getPoints(const float* t, glm::vec3* points, int count) const
+{
+    evaluateBatch(t, count, points, nullptr);
+}
+
+void Path::getTangents(const float* t, glm::vec3* tangents, int count) const
+{
+    evaluateBatch(t, count, nullptr, tangents);
+    for (int i = 0; i < count; i++)
+        tangents[i] = glm::normalize(tangents[i]);
+}
+
+void Path::getFrames(const float* t, PathFrame* frames, int count) const
+{
+    // po blokovima, da privremeni nizovi ostanu na steku
+    const int BLOCK = 256;
+    glm::vec3 points[BLOCK], derivatives[BLOCK];
+    for (int base = 0; base < count; base += BLOCK) {
+        int n = std::min(BLOCK, count - base);
+        evaluateBatch(t + base, n, points, derivatives);
+        for (int i = 0; i < n; i++)
+            frames[base + i] = makeFrame(points[i], glm::normalize(derivatives[i]), getOrientation(t[base + i]));
+    }
+}
+
+// ================= DUZINA LUKA =================
+void Path::buildArcLengthTable()
+{
+    if (isSpline())
+        arcLengthSamples = std::max(ARC_LENGTH_SAMPLES, (int)controlPoints.size() * ARC_LENGTH_SAMPLES_PER_SEGMENT);
+    const int n = arcLengthSamples;
+
+    // kumulativna duzina po ravnomernim koracima t-a
+    arcLengths.resize(n + 1);
+    arcLengths[0] = 0.0f;
+    double accumulated = 0.0;
+    glm::vec3 prev = getPoint(0.0f);
+    for (int i = 1; i <= n; i++) {
+        glm::vec3 p = getPoint(float(i) / n);
+        accumulated += glm::length(p - prev);
+        arcLengths[i] = (float)accumulated;
+        prev = p;
+    }
+    totalLength = arcLengths[n];
+
+    // inverzna tabela: za ravnomerne korake duzine trazi se interval (jednim prolazom, duzina samo raste)
+    tAtDistance.resize(n + 1);
+    int segment = 0;
+    for (int k = 0; k <= n; k++) {
+        float distance = totalLength * k / n;
+        while (segment < n - 1 && arcLengths[segment + 1] < distance)
+            segment++;
+        float s0 = arcLengths[segment];
+        float s1 = arcLengths[segment + 1];
+        float f = s1 > s0 ? (distance - s0) / (s1 - s0) : 0.0f;
+        tAtDistance[k] = (segment + std::clamp(f, 0.0f, 1.0f)) / n;
+    }
+}
+
+// linearna interpolacija u tabeli duzine luka, x je u [0, 1]
+float Path::lookup(const std::vector<float>& table, float x)
+{
+    const int n = (int)table.size() - 1;
+    float position = std::clamp(x, 0.0f, 1.0f) * n;
+    int i = std::min((int)position, n - 1);
+    float f = position - i;
+    return table[i] + (table[i + 1] - table[i]) * f;
+}
+
+float Path::getTotalLength() const
+{
+    return totalLength;
+}
+
+float Path::getDistanceAtT(float t) const
+{
+    return lookup(arcLengths, t);
+}
+
+float Path::getTAtDistance(float distance) const
+{
+    if (totalLength <= 0.0f)
+        return 0.0f;
+    return lookup(tAtDistance, distance / totalLength);
+}
+
+glm::vec3 Path::getPointAtDistance(float distance) const
+{
+    return getPoint(getTAtDistance(distance));
+}
+
+glm::vec3 Path::getTangentAtDistance(float distance) const
+{
+    return getTangent(getTAtDistance(distance));
+}
+
+// ================= TABELA OKVIRA =================
+void Path::buildFrameTable()
+{
+    if (isSpline()) {
+        int segments = (int)controlPoints.size();
+        frameSamples = segments * std::max(FRAME_SAMPLES_PER_SEGMENT, (FRAME_SAMPLES + segments - 1) / segments);
+    }
+    const int n = frameSamples;
+    std::vector<glm::vec3> tangents(n + 1), normals(n + 1);
+    std::vector<float> roll(n + 1, 0.0f);
+    posePositions.resize(n + 1);
+    poseOrientations.resize(n + 1);
+    for (int i = 0; i <= n; i++) {
+        posePositions[i] = getPoint(float(i) / n);
+        tangents[i] = getTangent(float(i) / n);
+    }
+
+    // prenos normale metodom dvostruke refleksije (Wang i dr., "Computation of rotation minimizing frames"):
+    // refleksija preko ravni normalne na tetivu, pa preko ravni koja preslikava tangentu na sledecu
+    normals[0] = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), tangents[0]));
+    for (int i = 0; i < n; i++) {
+        glm::vec3 v1 = posePositions[i + 1] - posePositions[i];
+        float c1 = glm::dot(v1, v1);
+        if (c1 < 1e-12f) {
+            normals[i + 1] = normals[i];
+            continue;
+        }
+        glm::vec3 rL = normals[i] - (2.0f / c1) * glm::dot(v1, normals[i]) * v1;
+        glm::vec3 tL = tangents[i] - (2.0f / c1) * glm::dot(v1, tangents[i]) * v1;
+        glm::vec3 v2 = tangents[i + 1] - tL;
+        float c2 = glm::dot(v2, v2);
+        glm::vec3 r = c2 < 1e-12f ? rL : rL - (2.0f / c2) * glm::dot(v2, rL) * v2;
+        // greska se ne sabira: normala se vraca na ravan normalnu na tangentu
+        normals[i + 1] = glm::normalize(r - tangents[i + 1] * glm::dot(r, tangents[i + 1]));
+    }
+
+    // nagib: bocna komponenta vektora krivine (ka centru okreta) puta poluprecnik okretnice je 1 u okretnicama,
+    // 0 na pravim delovima i brdima; znak je takav da se kola naginju ka unutrasnjosti okreta
+    if (isSpline()) {
+        for (int i = 0; i <= n; i++)
+            roll[i] = glm::radians(splineBank(float(i) / n));
+    }
+    else if (bankAngle != 0.0f) {
+        for (int i = 0; i <= n; i++) {
+            float t = float(i) / n;
+            glm::vec3 d1 = getDerivative(t);
+            glm::vec3 d2 = getSecondDerivative(t);
+            float speed2 = glm::dot(d1, d1);
+            glm::vec3 curvature = (d2 - d1 * (glm::dot(d1, d2) / speed2)) / speed2;
+            float lateral = std::clamp(glm::dot(normals[i], curvature) * turnRadius, -1.0f, 1.0f);
+            roll[i] = -glm::radians(bankAngle) * lateral;
+        }
+        // klizni prosek (preko prefiksnih suma) da nagib raste postepeno na ulazu u okretnicu
+        const int SMOOTHING = n / 64;
+        std::vector<double> prefix(n + 2, 0.0);
+        for (int i = 0; i <= n; i++)
+            prefix[i + 1] = prefix[i] + roll[i];
+        for (int i = 0; i <= n; i++) {
+            int from = std::max(0, i - SMOOTHING), to = std::min(n, i + SMOOTHING);
+            roll[i] = (float)((prefix[to + 1] - prefix[from]) / (to - from + 1));
+        }
+    }
+
+    // zatvorena staza: ugao za koji treba zarotirati preneti krajnji okvir da se poklopi sa pocetnim,
+    // dodaje se srazmerno predjenom putu (za ugradjenu stazu je ~0, jer su okretnice u ravni)
+    if (glm::length(posePositions[n] - posePositions[0]) < 1e-3f && glm::dot(tangents[n], tangents[0]) > 0.999f) {
+        glm::vec3 binormalEnd = glm::cross(tangents[n], normals[n]);
+        float seam = atan2(glm::dot(normals[0], binormalEnd), glm::dot(normals[0], normals[n]));
+        for (int i = 0; i <= n; i++)
+            roll[i] += seam * getDistanceAtT(float(i) / n) / totalLength;
+    }
+
+    for (int i = 0; i <= n; i++) {
+        glm::vec3 T = tangents[i];
+        glm::vec3 N = normals[i];
+        glm::vec3 B = glm::cross(T, N);
+        if (roll[i] != 0.0f) {
+            float c = cos(roll[i]), s = sin(roll[i]);
+            N = N * c + B * s;
+            B = glm::cross(T, N);
+        }
+        poseOrientations[i] = glm::normalize(glm::quat_cast(glm::mat3(N, B, T)));
+        // q i -q su ista rotacija; susedni uzorci istog znaka da slerp ide kracim putem
+        if (i > 0 && glm::dot(poseOrientations[i], poseOrientations[i - 1]) < 0.0f)
+            poseOrientations[i] = -poseOrientations[i];
+    }
+}
+
+glm::quat Path::getOrientation(float t) const
+{
+    float position = std::clamp(t, 0.0f, 1.0f) * frameSamples;
+    int i = std::min((int)position, frameSamples - 1);
+    return glm::slerp(poseOrientations[i], poseOrientations[i + 1], position - i);
+}
+
+PathPose Path::getPose(float t) const
+{
+    float position = std::clamp(t, 0.0f, 1.0f) * frameSamples;
+    int i = std::min((int)position, frameSamples - 1);
+    float f = position - i;
+
+    PathPose pose;
+    pose.position = glm::mix(posePositions[i], posePositions[i + 1], f);
+    pose.orientation = glm::slerp(poseOrientations[i], poseOrientations[i + 1], f);
+    return pose;
 }
 
 // ================= SEGMENTS =================
@@ -100,3 +576,132 @@ glm::vec3 Path::turnTrackBack(float t) const
 
     return origin + glm::vec3(x, y, z);
 }
+
+// ================= IZVODI SEGMENATA =================
+glm::vec3 Path::forwardTrackDerivative(float t) const
+{
+    // x = t * length, y je konstantno do 0.2 pa sinusoida po t2 = (t - 0.2) / 0.8
+    if (t < 0.2f)
+        return glm::vec3(length, 0.0f, 0.0f);
+
+    float t2 = (t - 0.2f) / 0.8f;
+    float k = 2.0f * hills * glm::pi<float>() / 0.8f;   // izvod ugla po t
+    float angle = 2.0f * hills * glm::pi<float>() * t2 - glm::half_pi<float>();
+    return glm::vec3(length, amplitude * k * cos(angle), 0.0f);
+}
+
+glm::vec3 Path::forwardTrackSecondDerivative(float t) const
+{
+    if (t < 0.2f)
+        return glm::vec3(0.0f);
+
+    float t2 = (t - 0.2f) / 0.8f;
+    float k = 2.0f * hills * glm::pi<float>() / 0.8f;
+    float angle = 2.0f * hills * glm::pi<float>() * t2 - glm::half_pi<float>();
+    return glm::vec3(0.0f, -amplitude * k * k * sin(angle), 0.0f);
+}
+
+glm::vec3 Path::turnTrackDerivative(float t) const
+{
+    float angle = t * glm::pi<float>();
+    float k = turnRadius * glm::pi<float>();
+    return glm::vec3(k * cos(angle), 0.0f, k * sin(angle));
+}
+
+glm::vec3 Path::turnTrackSecondDerivative(float t) const
+{
+    float angle = t * glm::pi<float>();
+    float k = turnRadius * glm::pi<float>() * glm::pi<float>();
+    return glm::vec3(-k * sin(angle), 0.0f, k * cos(angle));
+}
+
+glm::vec3 Path::returnTrackDerivative(float t) const
+{
+    return glm::vec3(-length, 0.0f, 0.0f);
+}
+
+glm::vec3 Path::turnTrackBackDerivative(float t) const
+{
+    float angle = t * glm::pi<float>();
+    float k = turnRadius * glm::pi<float>();
+    return glm::vec3(-k * cos(angle), 0.0f, -k * sin(angle));
+}
+
+glm::vec3 Path::turnTrackBackSecondDerivative(float t) const
+{
+    float angle = t * glm::pi<float>();
+    float k = turnRadius * glm::pi<float>() * glm::pi<float>();
+    return glm::vec3(k * sin(angle), 0.0f, -k * cos(angle));
+}
+
+// ================= STAZA IZ FAJLA =================
+void Path::buildSpline()
+{
+    /*
+        uniformni Catmull-Rom kroz zatvoren niz tacaka: segment od P1 do P2 (susedi P0 i P3) je
+            P(u) = 0.5 * (2 P1 + (P2 - P0) u + (2 P0 - 5 P1 + 4 P2 - P3) u^2 + (3 P1 - P0 - 3 P2 + P3) u^3)
+        tangenta je neprekidna na spojevima; isto se radi za nagib
+    */
+    const int n = (int)controlPoints.size();
+    splineCoefficients.resize(n * 4);
+    bankCoefficients.resize(n);
+    for (int i = 0; i < n; i++) {
+        const TrackControlPoint& c0 = controlPoints[(i + n - 1) % n];
+        const TrackControlPoint& c1 = controlPoints[i];
+        const TrackControlPoint& c2 = controlPoints[(i + 1) % n];
+        const TrackControlPoint& c3 = controlPoints[(i + 2) % n];
+
+        glm::vec3 p0 = c0.position, p1 = c1.position, p2 = c2.position, p3 = c3.position;
+        splineCoefficients[i * 4 + 0] = origin + p1;
+        splineCoefficients[i * 4 + 1] = 0.5f * (p2 - p0);
+        splineCoefficients[i * 4 + 2] = 0.5f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3);
+        splineCoefficients[i * 4 + 3] = 0.5f * (3.0f * p1 - p0 - 3.0f * p2 + p3);
+
+        float b0 = c0.bank, b1 = c1.bank, b2 = c2.bank, b3 = c3.bank;
+        bankCoefficients[i] = glm::vec4(
+            b1,
+            0.5f * (b2 - b0),
+            0.5f * (2.0f * b0 - 5.0f * b1 + 4.0f * b2 - b3),
+            0.5f * (3.0f * b1 - b0 - 3.0f * b2 + b3));
+    }
+}
+
+// segment za t i lokalni parametar u u [0, 1]
+int Path::splineSegment(float t, float& u) const
+{
+    const int n = (int)controlPoints.size();
+    float position = std::clamp(t, 0.0f, 1.0f) * n;
+    int i = std::min((int)position, n - 1);
+    u = position - i;
+    return i;
+}
+
+glm::vec3 Path::splinePoint(float t) const
+{
+    float u;
+    const glm::vec3* c = &splineCoefficients[splineSegment(t, u) * 4];
+    return c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+}
+
+glm::vec3 Path::splineDerivative(float t) const
+{
+    // segment zauzima 1 / n t-a, pa je dP/dt = n * dP/du
+    float u;
+    const glm::vec3* c = &splineCoefficients[splineSegment(t, u) * 4];
+    return (c[1] + u * (2.0f * c[2] + u * 3.0f * c[3])) * (float)controlPoints.size();
+}
+
+glm::vec3 Path::splineSecondDerivative(float t) const
+{
+    float u;
+    const glm::vec3* c = &splineCoefficients[splineSegment(t, u) * 4];
+    float n = (float)controlPoints.size();
+    return (2.0f * c[2] + 6.0f * u * c[3]) * (n * n);
+}
+
+float Path::splineBank(float t) const
+{
+    float u;
+    const glm::vec4& c = bankCoefficients[splineSegment(t, u)];
+    return c.x + u * (c.y + u * (c.z + u * c.w));
+}
@@ -1,5 +1,54 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <string>
+#include <vector>
+
+// kontrolna tacka staze iz fajla: pozicija (u odnosu na origin) i nagib oko tangente u stepenima
+// (pozitivan nagib spusta desnu stranu staze, gledano u smeru voznje)
+struct TrackControlPoint {
+    glm::vec3 position;
+    float bank = 0.0f;
+};
+
+// parametri putanje (da mogu da se menjaju u toku rada i da se od njih napravi nova putanja)
+struct PathParams {
+    float length = 40.0f;
+    float returnOffsetZ = 3.0f;
+    float baseHeight = 1.0f;
+    float amplitude = 4.0f;
+    int hills = 3;
+    glm::vec3 origin = glm::vec3(0.0f);
+    float bankAngle = 0.0f;     // najveci nagib u okretnicama u stepenima (0 = bez nagiba)
+    // ako nije prazno, staza je zatvoreni Catmull-Rom kroz ove tacke (od parametara iznad se koristi samo origin)
+    std::vector<TrackControlPoint> controlPoints;
+};
+
+// okvir u tacki putanje: tangenta, normala (u stranu) i binormala (gore u odnosu na stazu);
+// normala i binormala su iz tabele okvira bez uvrtanja (vidi Path::getPose), tangenta je tacna
+struct PathFrame {
+    glm::vec3 position;
+    glm::vec3 tangent;
+    glm::vec3 normal;
+    glm::vec3 binormal;
+};
+
+// poza u tacki putanje: kolone matrice orijentacije su (normala, binormala, tangenta), kao model matrica kola
+struct PathPose {
+    glm::vec3 position;
+    glm::quat orientation;
+};
+
+// unapred izracunate tabele putanje (pogled na tudju memoriju, npr. mapiran fajl pecene staze iz track_bundle.hpp);
+// nizovi imaju po jedan element vise od broja intervala
+struct PathTables {
+    const float* arcLengths = nullptr;
+    const float* tAtDistance = nullptr;
+    int arcLengthSamples = 0;
+    const glm::vec3* posePositions = nullptr;
+    const glm::quat* poseOrientations = nullptr;
+    int frameSamples = 0;
+};
 
 class Path {
 public:
@@ -9,12 +58,53 @@ public:
         float baseHeight,
         float amplitude,
         int hills,
-        glm::vec3 origin
+        glm::vec3 origin,
+        float bankAngle = 0.0f
     );
+    explicit Path(const PathParams& params);
+    // ista putanja, ali se tabele duzine luka i okvira samo kopiraju (tables mora biti napravljeno od istih parametara)
+    Path(const PathParams& params, const PathTables& tables);
+
+    PathParams getParams() const;
+    PathTables getTables() const;
+    bool isSpline() const;
+
+    // kontrolne tacke iz tekstualnog fajla: po jedna u redu "x y z [nagib]", prazni redovi i # komentari se preskacu
+    static bool loadControlPoints(const std::string& file, std::vector<TrackControlPoint>& points);
 
     // api koji ce da koriste rollercoaster i cart (vrv i seats i ljudi i pojasevi)
     glm::vec3 getPoint(float t) const;
+    // izvodi po t u zatvorenom obliku (po segmentima, sa faktorom za deo t-a koji segment zauzima)
+    glm::vec3 getDerivative(float t) const;
+    glm::vec3 getSecondDerivative(float t) const;
     glm::vec3 getTangent(float t) const;
+    // krivina |P' x P''| / |P'|^3 (1 / poluprecnik, 0 na pravim delovima)
+    float getCurvature(float t) const;
+    PathFrame getFrame(float t) const;
+    // poza iz tabele okvira: pozicija linearno, orijentacija slerp izmedju dva susedna uzorka
+    PathPose getPose(float t) const;
+
+    // isto za niz parametara odjednom (count elemenata): po 4 t-a sa SIMD sin/cos (simd_math.hpp);
+    // rezultat se od pojedinacnih poziva razlikuje samo u greski sin/cos (~1e-7)
+    void getPoints(const float* t, glm::vec3* points, int count) const;
+    void getTangents(const float* t, glm::vec3* tangents, int count) const;
+    void getFrames(const float* t, PathFrame* frames, int count) const;
+
+    // isto, ali po predjenom putu u metrima (t ne raste ravnomerno sa duzinom: brda i okretnice
+    // dobijaju razlicit deo t-a), lookup je konstantnog vremena preko tabele duzine luka
+    float getTotalLength() const;
+    float getDistanceAtT(float t) const;
+    float getTAtDistance(float distance) const;
+    glm::vec3 getPointAtDistance(float distance) const;
+    glm::vec3 getTangentAtDistance(float distance) const;
+
+    // broj intervala tabele duzine luka (i inverzne tabele); staza iz fajla ima bar ARC_LENGTH_SAMPLES_PER_SEGMENT po segmentu
+    static const int ARC_LENGTH_SAMPLES = 8192;
+    static const int ARC_LENGTH_SAMPLES_PER_SEGMENT = 16;
+    // broj intervala tabele okvira (deljiv sa 10, da granice segmenata 0.4, 0.5 i 0.9 padnu tacno na uzorke,
+    // pa nijedan interval ne prelazi preko spoja gde se menja brzina po t); za stazu iz fajla ceo broj uzoraka po segmentu
+    static const int FRAME_SAMPLES = 4000;
+    static const int FRAME_SAMPLES_PER_SEGMENT = 4;
 
 private:
     float length;
@@ -24,9 +114,66 @@ private:
     float amplitude;
     int hills;
     glm::vec3 origin;
+    float bankAngle;
+
+    /*
+        staza iz fajla: segment i ide od tacke i do i + 1 i zauzima 1 / n t-a (segment se nalazi u konstantnom vremenu),
+        po segmentu se cuvaju koeficijenti kubnog polinoma P(u) = a + b u + c u^2 + d u^3 (uniformni Catmull-Rom),
+        isto za nagib; prazno za ugradjenu stazu
+    */
+    std::vector<TrackControlPoint> controlPoints;
+    std::vector<glm::vec3> splineCoefficients;     // a, b, c, d po segmentu
+    std::vector<glm::vec4> bankCoefficients;       // a, b, c, d po segmentu (stepeni)
+
+    void buildSpline();
+    int splineSegment(float t, float& u) const;
+    glm::vec3 splinePoint(float t) const;
+    glm::vec3 splineDerivative(float t) const;
+    glm::vec3 splineSecondDerivative(float t) const;
+    float splineBank(float t) const;
 
     glm::vec3 forwardTrack(float t) const;
     glm::vec3 turnTrack(float t) const;
     glm::vec3 returnTrack(float t) const;
     glm::vec3 turnTrackBack(float t) const;
+
+    // prvi i drugi izvod segmenta po njegovom lokalnom parametru
+    glm::vec3 forwardTrackDerivative(float t) const;
+    glm::vec3 forwardTrackSecondDerivative(float t) const;
+    glm::vec3 turnTrackDerivative(float t) const;
+    glm::vec3 turnTrackSecondDerivative(float t) const;
+    glm::vec3 returnTrackDerivative(float t) const;
+    glm::vec3 turnTrackBackDerivative(float t) const;
+    glm::vec3 turnTrackBackSecondDerivative(float t) const;
+
+    // tacke i/ili prvi izvodi za niz t-ova (izlaz koji je nullptr se ne racuna)
+    void evaluateBatch(const float* t, int count, glm::vec3* points, glm::vec3* derivatives) const;
+
+    // arcLengths[i]: duzina luka do t = i / ARC_LENGTH_SAMPLES
+    // tAtDistance[k]: t na duzini k / ARC_LENGTH_SAMPLES * totalLength
+    std::vector<float> arcLengths;
+    std::vector<float> tAtDistance;
+    float totalLength = 0.0f;
+    int arcLengthSamples = ARC_LENGTH_SAMPLES;
+
+    void buildArcLengthTable();
+
+    /*
+        tabela okvira (rotation-minimizing frame) po ravnomernim koracima t-a:
+            - pocetni okvir je kao ranije (normala = cross(gore, T)), dalje se prenosi metodom dvostruke refleksije,
+              pa se ne uvrce i radi i na vertikalnim i obrnutim delovima (gde cross(gore, T) nema smisla)
+            - nagib (bankAngle) je rotacija oko tangente srazmerna bocnoj krivini (pun nagib u okretnicama),
+              izgladjen da ne skace na spojevima segmenata; staza iz fajla umesto toga koristi nagib iz kontrolnih tacaka
+            - na zatvorenoj stazi preneti okvir se na kraju ne poklapa obavezno sa pocetnim, pa se razlika
+              rasporedjuje po duzini (inace bi kola na spoju naglo rotirala)
+    */
+    std::vector<glm::vec3> posePositions;
+    std::vector<glm::quat> poseOrientations;
+    int frameSamples = FRAME_SAMPLES;
+
+    void buildFrameTable();
+    glm::quat getOrientation(float t) const;
+    // normala i binormala iz orijentacije, ortogonalizovane na tacnu tangentu
+    static PathFrame makeFrame(const glm::vec3& position, const glm::vec3& tangent, const glm::quat& orientation);
+    static float lookup(const std::vector<float>& table, float x);
 };
\ No newline at end of file
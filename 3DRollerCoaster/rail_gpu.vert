@@ -0,0 +1,32 @@
+#version 330 core
+// sablon jednog segmenta (obe sine): presek u ravni okvira i na kom kraju segmenta je verteks
+layout (location = 0) in vec4 inProfile;    // xy: tacka preseka, zw: normala u ravni preseka
+layout (location = 1) in vec3 inParams;     // x: u teksture, y: prsten (0 / 1), z: strana (-1 leva / 1 desna sina)
+
+out vec3 chFragPos;
+out vec3 chNormal;
+out vec2 chUV;
+
+// okviri u cvorovima sina (GpuRails): po cvoru tri teksela (pozicija i v, normala, binormala)
+uniform samplerBuffer uSamples;
+uniform float uRailOffset;
+uniform mat4 uV;
+uniform mat4 uP;
+
+void main()
+{
+    // instanca je segment, spaja cvorove gl_InstanceID i gl_InstanceID + 1
+    int knot = gl_InstanceID + int(inParams.y);
+    vec4 position = texelFetch(uSamples, knot * 3);
+    vec3 normal = texelFetch(uSamples, knot * 3 + 1).xyz;
+    vec3 binormal = texelFetch(uSamples, knot * 3 + 2).xyz;
+
+    // isti racun kao generateRails (railPoint) i SweepBuilder::writeRings;
+    // staza je u svetskim koordinatama (uM je jedinicna), pa uM ne treba
+    vec3 center = position.xyz + inParams.z * normal * uRailOffset;
+    chFragPos = center + normal * inProfile.x + binormal * inProfile.y;
+    chNormal = normal * inProfile.z + binormal * inProfile.w;
+    chUV = vec2(inParams.x, position.w);
+
+    gl_Position = uP * uV * vec4(chFragPos, 1.0);
+}
@@ -0,0 +1,66 @@
+#include "render_on_demand.hpp"
+#include <iostream>
+
+RenderOnDemand::RenderOnDemand(int settleFrames) :
+settleFrames(settleFrames)
+{
+}
+
+void RenderOnDemand::setEnabled(bool enabled) {
+    this->enabled = enabled;
+    dirty = true;
+}
+
+bool RenderOnDemand::isEnabled() const {
+    return enabled;
+}
+
+void RenderOnDemand::markDirty() {
+    dirty = true;
+}
+
+bool RenderOnDemand::shouldRender(const glm::mat4& view, const SceneSnapshot& snapshot, float cartT) {
+    bool changed = dirty || !hasLast || view != lastView || cartT != lastCartT || snapshot.rideState != lastRideState;
+    for (int i = 0; i < MAX_PASSENGERS && !changed; i++) {
+        const PassengerSnapshot& now = snapshot.passengers[i];
+        const PassengerSnapshot& last = lastPassengers[i];
+        changed = now.isActive != last.isActive || now.isSick != last.isSick || now.isBeltOn != last.isBeltOn;
+    }
+
+    if (changed) {
+        dirty = false;
+        hasLast = true;
+        lastView = view;
+        lastCartT = cartT;
+        lastRideState = snapshot.rideState;
+        for (int i = 0; i < MAX_PASSENGERS; i++)
+            lastPassengers[i] = snapshot.passengers[i];
+        settleLeft = settleFrames;
+    }
+
+    bool render = !enabled || changed || settleLeft > 0;
+    if (!changed && settleLeft > 0)
+        settleLeft--;
+
+    if (render)
+        renderedFrames++;
+    else
+        skippedFrames++;
+    return render;
+}
+
+long long RenderOnDemand::getRenderedFrames() const {
+    return renderedFrames;
+}
+
+long long RenderOnDemand::getSkippedFrames() const {
+    return skippedFrames;
+}
+
+void RenderOnDemand::printStats() const {
+    long long total = renderedFrames + skippedFrames;
+    std::cout << "Crtanje na zahtev: nacrtano " << renderedFrames << ", preskoceno " << skippedFrames << " frejmova";
+    if (total > 0)
+        std::cout << " (" << skippedFrames * 100.0 / total << "% preskoceno)";
+    std::cout << std::endl;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "scene_snapshot.hpp"
+#include <glm/glm.hpp>
+
+/*
+    crtanje samo kad se nesto promenilo (npr. kiosk gde voznja vecinu dana stoji):
+        - prati ono od cega zavisi slika: view matricu (kamera, ukljucujuci kameru putnika),
+          polozaj kola, stanje voznje i putnika, plus eksplicitne promene (markDirty: ulaz, toggle-ovi, nova staza, expose prozora)
+        - posle poslednje promene se crta jos settleFrames frejmova (occlusion culling koristi rezultate prethodnog frejma)
+        - kad nema promena frejm se preskace, a prozor i dalje prikazuje poslednju sliku
+*/
+class RenderOnDemand {
+public:
+    explicit RenderOnDemand(int settleFrames = 2);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // nesto sto se ne vidi kroz stanje scene se promenilo
+    void markDirty();
+    // da li ovaj frejm treba nacrtati (cartT je interpolirani polozaj kola koji bi se nacrtao)
+    bool shouldRender(const glm::mat4& view, const SceneSnapshot& snapshot, float cartT);
+
+    long long getRenderedFrames() const;
+    long long getSkippedFrames() const;
+    void printStats() const;
+
+private:
+    bool enabled = false;
+    bool dirty = true;
+    int settleFrames;
+    int settleLeft = 0;
+
+    bool hasLast = false;
+    glm::mat4 lastView = glm::mat4(1.0f);
+    float lastCartT = 0.0f;
+    RideState lastRideState = RideState::READY;
+    PassengerSnapshot lastPassengers[MAX_PASSENGERS];
+
+    long long renderedFrames = 0;
+    long long skippedFrames = 0;
+};
@@ -1,8 +1,8 @@
 #include "ride_controller.hpp"
 #include "ride_state.hpp"
 
-RideController::RideController(std::vector<HumanoidModel>& seatedHumanoids): 
-seatedHumanoids(seatedHumanoids),
+RideController::RideController(const std::vector<Passenger*>& passengers): 
+passengers(passengers),
 rideState(RideState::READY),
 numberOfPassangers(0) {}
 
@@ -10,9 +10,9 @@ void RideController::addPassanger() {
 	if (numberOfPassangers >= 8 || rideState != RideState::READY)
 		return;
 
-	for (HumanoidModel& h : seatedHumanoids) {
-		if (h.seatIndex == numberOfPassangers) {
-			h.isActive = true;
+	for (Passenger* h : passengers) {
+		if (h->seatIndex == numberOfPassangers) {
+			h->isActive = true;
 			break;
 		}
 	}
@@ -24,9 +24,9 @@ void RideController::rideStarted() {
 	if (rideState != RideState::READY)
 		return;
 
-	for (HumanoidModel& h : seatedHumanoids) {
+	for (Passenger* h : passengers) {
 		// ako imamo putnika u kolima koji se nije vezao ne desi se nista
-		if (h.isActive && !h.isBeltOn)
+		if (h->isActive && !h->isBeltOn)
 			return;
 	}
 
@@ -49,17 +49,17 @@ void RideController::rideEnded() {
 	rideState = numberOfPassangers != 0 ? RideState::DEPARTURE : RideState::READY;
 
 	// odvezati pojaseve na kraju voznje
-	for (HumanoidModel& h : seatedHumanoids) {
-		h.putBeltOff();
+	for (Passenger* h : passengers) {
+		h->putBeltOff();
 	}
 }
 
 void RideController::passangerInteraction(int seatIndex) {
 	// ako je u toku departure - putnik napusta svoje mesto
 	if (rideState == RideState::DEPARTURE) {
-		for (HumanoidModel& h : seatedHumanoids) {
-			if (h.seatIndex == seatIndex && h.isActive) {
-				h.leave();
+		for (Passenger* h : passengers) {
+			if (h->seatIndex == seatIndex && h->isActive) {
+				h->leave();
 				numberOfPassangers--;
 				break;
 			}
@@ -71,9 +71,9 @@ void RideController::passangerInteraction(int seatIndex) {
 	}
 	// ako je u toku voznja - putniku se slosilo
 	if (rideState == RideState::ACTIVE || rideState == RideState::SOMEONE_SICK) {
-		for (HumanoidModel& h : seatedHumanoids) {
-			if (h.seatIndex == seatIndex && h.isActive) {
-				h.becomeSick();
+		for (Passenger* h : passengers) {
+			if (h->seatIndex == seatIndex && h->isActive) {
+				h->becomeSick();
 				rideState = RideState::SOMEONE_SICK;
 				break;
 			}
@@ -81,9 +81,9 @@ void RideController::passangerInteraction(int seatIndex) {
 	}
 	// ako su kola spremna za voznju - putnik se veze
 	if (rideState == RideState::READY) {
-		for (HumanoidModel& h : seatedHumanoids) {
-			if (h.seatIndex == seatIndex && h.isActive) {
-				h.putBeltOn();
+		for (Passenger* h : passengers) {
+			if (h->seatIndex == seatIndex && h->isActive) {
+				h->putBeltOn();
 				break;
 			}
 		}
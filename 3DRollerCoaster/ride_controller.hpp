@@ -1,12 +1,12 @@
 #pragma once
-#include "humanoid_model.hpp"
+#include "passenger.hpp"
 #include "ride_state.hpp"
 #include <glm/glm.hpp>
 #include <vector>
 
 class RideController {
 public:
-    RideController(std::vector<HumanoidModel>& seatedHumanoids);
+    RideController(const std::vector<Passenger*>& passengers);
     void addPassanger();
     int getNumberOfPassangers();
     RideState getRideState();
@@ -15,7 +15,7 @@ public:
     void rideStarted();
     void rideEnded();
 private:
-    std::vector<HumanoidModel>& seatedHumanoids;
+    std::vector<Passenger*> passengers;
     RideState rideState;
     int numberOfPassangers;
 };
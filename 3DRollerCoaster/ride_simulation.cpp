@@ -0,0 +1,178 @@
+#include "ride_simulation.hpp"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+
+RideSimulation::RideSimulation(CartMotion* cartMotion, RideController* rideController, const std::vector<Passenger*>& passengers) :
+cartMotion(cartMotion),
+rideController(rideController),
+passengers(passengers)
+{
+    // pocetni snapshot da render ima sta da cita pre prvog koraka
+    publishSnapshot(CartMotion::FIXED_DT);
+    snapshots.update();
+}
+
+RideSimulation::~RideSimulation() {
+    stop();
+}
+
+double RideSimulation::clockNow() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RideSimulation::start() {
+    if (running.exchange(true)) return;
+    thread = std::thread(&RideSimulation::run, this);
+}
+
+bool RideSimulation::isRunning() const {
+    return running.load();
+}
+
+void RideSimulation::stop() {
+    if (!running.exchange(false)) return;
+    thread.join();
+}
+
+bool RideSimulation::isRideKey(int key) {
+    return key == GLFW_KEY_ENTER || key == GLFW_KEY_SPACE || (key >= GLFW_KEY_1 && key <= GLFW_KEY_8);
+}
+
+bool RideSimulation::pushInput(const InputEvent& event) {
+    if (inputEvents.push(event))
+        return true;
+    droppedInputEvents.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void RideSimulation::setTimeScale(float scale) {
+    timeScale.store(scale);
+}
+
+float RideSimulation::getTimeScale() const {
+    return timeScale.load();
+}
+
+void RideSimulation::processInput() {
+    // svi dogadjaji koji su stigli do pocetka ovog koraka
+    InputEvent event;
+    while (inputEvents.pop(event)) {
+        inputStats.recordProcessed(event, inputTimestampNow());
+        if (event.type != InputEventType::KEY_PRESS)
+            continue;
+
+        // na enter pocinje voznja
+        if (event.key == GLFW_KEY_ENTER)
+            rideController->rideStarted();
+        // na space punimo cart putnicima
+        if (event.key == GLFW_KEY_SPACE)
+            rideController->addPassanger();
+        // na tastere 1-8 "nesto radimo sa putnicima"
+        if (event.key >= GLFW_KEY_1 && event.key <= GLFW_KEY_8)
+            rideController->passangerInteraction(event.key - GLFW_KEY_1);
+    }
+}
+
+void RideSimulation::publishSnapshot(double period) {
+    SceneSnapshot& snapshot = snapshots.writeBuffer();
+    snapshot.tick = tickCount.load(std::memory_order_relaxed);
+    snapshot.tickTime = clockNow();
+    snapshot.tickPeriod = period;
+    snapshot.prevT = cartMotion->getPrevT();
+    snapshot.t = cartMotion->getT();
+    snapshot.rideState = rideController->getRideState();
+    for (int i = 0; i < MAX_PASSENGERS; i++) {
+        PassengerSnapshot& passenger = snapshot.passengers[i];
+        if (i < (int)passengers.size()) {
+            passenger.isActive = passengers[i]->isActive;
+            passenger.isSick = passengers[i]->isSick;
+            passenger.isBeltOn = passengers[i]->isBeltOn;
+        }
+        else {
+            passenger = PassengerSnapshot();
+        }
+    }
+    snapshots.publish();
+}
+
+void RideSimulation::tick(double period) {
+    processInput();
+    cartMotion->step();
+    // release: ko vidi novi broj koraka, vidi i da je korak zavrsio sa putanjom (TrackRebuilder)
+    tickCount.fetch_add(1, std::memory_order_release);
+    publishSnapshot(period);
+}
+
+float RideSimulation::stepFrame(float frameTime) {
+    accumulator += frameTime * timeScale.load();
+    // najvise CartMotion::MAX_STEPS_PER_FRAME koraka po frejmu (pomnozeno brzinom simulacije): posle dugog frejma
+    // se visak vremena odbacuje, inace bi sustizanje produzilo sledeci frejm (spirala smrti)
+    float maxAccumulated = CartMotion::FIXED_DT * CartMotion::MAX_STEPS_PER_FRAME * std::max(timeScale.load(), 1.0f);
+    if (accumulator > maxAccumulated)
+        accumulator = maxAccumulated;
+
+    while (accumulator >= CartMotion::FIXED_DT) {
+        tick(CartMotion::FIXED_DT);
+        accumulator -= CartMotion::FIXED_DT;
+    }
+    return accumulator / CartMotion::FIXED_DT;
+}
+
+void RideSimulation::run() {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point nextTick = Clock::now();
+
+    while (running.load()) {
+        double period = CartMotion::FIXED_DT / std::max(timeScale.load(), 0.01f);
+        tick(period);
+
+        nextTick += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period));
+        Clock::time_point now = Clock::now();
+        // ako simulacija zaostane vise od jednog koraka ne stizemo propustene korake naglo
+        if (now - nextTick > std::chrono::duration<double>(period))
+            nextTick = now;
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+const SceneSnapshot& RideSimulation::acquireSnapshot() {
+    if (snapshots.update())
+        newSnapshotFrames++;
+    else
+        reusedSnapshotFrames++;
+    return snapshots.readBuffer();
+}
+
+float RideSimulation::interpolationAlpha(const SceneSnapshot& snapshot, double now) {
+    if (snapshot.tickPeriod <= 0.0)
+        return 1.0f;
+    double alpha = (now - snapshot.tickTime) / snapshot.tickPeriod;
+    return (float)std::clamp(alpha, 0.0, 1.0);
+}
+
+long long RideSimulation::getTickCount() const {
+    return tickCount.load(std::memory_order_acquire);
+}
+
+float RideSimulation::getT() const {
+    return cartMotion->getT();
+}
+
+RideState RideSimulation::getRideState() const {
+    return rideController->getRideState();
+}
+
+long long RideSimulation::getNewSnapshotFrames() const {
+    return newSnapshotFrames;
+}
+
+long long RideSimulation::getReusedSnapshotFrames() const {
+    return reusedSnapshotFrames;
+}
+
+InputStats RideSimulation::getInputStats() const {
+    InputStats stats = inputStats;
+    stats.dropped = droppedInputEvents.load();
+    return stats;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "cart_motion.hpp"
+#include "ride_controller.hpp"
+#include "passenger.hpp"
+#include "scene_snapshot.hpp"
+#include "triple_buffer.hpp"
+#include "spsc_queue.hpp"
+#include "input_event.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/*
+    simulacija voznje (CartMotion::step, RideController, stanje putnika) na posebnoj niti:
+        - koraci idu fiksnim tempom CartMotion::FIXED_DT / timeScale
+        - posle svakog koraka se objavljuje SceneSnapshot kroz trostruki bafer,
+          render nit ga cita bez blokiranja i interpolira polozaj kola
+        - posle start() stanje kola, kontrolera i putnika sme da menja samo sim nit
+        - bez start() simulaciju tera render nit kroz stepFrame (lockstep za snimanje i reprodukciju sesije)
+*/
+class RideSimulation {
+public:
+    RideSimulation(CartMotion* cartMotion, RideController* rideController, const std::vector<Passenger*>& passengers);
+    ~RideSimulation();
+
+    void start();
+    void stop();
+    // da li koraci idu na sim niti (inace ih tera stepFrame)
+    bool isRunning() const;
+
+    // lockstep: koraci za dt jednog frejma na pozivajucoj niti, vraca faktor interpolacije
+    // (dogadjaji se obradjuju na pocetku prvog koraka posle njihovog dolaska, isto kao na sim niti)
+    float stepFrame(float frameTime);
+
+    // da li taster pripada logici voznje (ENTER, SPACE, 1-8)
+    static bool isRideKey(int key);
+    // GLFW callback: dogadjaj za kontroler voznje, obradjuje se na pocetku sledeceg koraka
+    bool pushInput(const InputEvent& event);
+
+    void setTimeScale(float scale);
+    float getTimeScale() const;
+
+    // render nit: preuzima najnoviji snapshot (ako ga ima) i vraca ga
+    const SceneSnapshot& acquireSnapshot();
+    // render nit: faktor interpolacije izmedju prevT i t za trenutak "now" (steady_clock sekunde)
+    static float interpolationAlpha(const SceneSnapshot& snapshot, double now);
+    static double clockNow();
+
+    // broj zavrsenih koraka (sluzi i kao ograda: kad poraste, korak koji je bio u toku je zavrsen)
+    long long getTickCount() const;
+    float getT() const;
+    RideState getRideState() const;
+    long long getNewSnapshotFrames() const;
+    long long getReusedSnapshotFrames() const;
+    // citati tek posle stop()
+    InputStats getInputStats() const;
+
+private:
+    CartMotion* cartMotion;
+    RideController* rideController;
+    std::vector<Passenger*> passengers;
+
+    TripleBuffer<SceneSnapshot> snapshots;
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    std::atomic<float> timeScale{ 1.0f };
+    std::atomic<long long> tickCount{ 0 };
+
+    // dogadjaji sa ulaza: proizvodjac je GLFW callback (render nit), potrosac je sim nit
+    SpscQueue<InputEvent, 256> inputEvents;
+    std::atomic<long long> droppedInputEvents{ 0 };
+    InputStats inputStats;
+
+    float accumulator = 0.0f;    // samo za stepFrame
+
+    long long newSnapshotFrames = 0;
+    long long reusedSnapshotFrames = 0;
+
+    void run();
+    void tick(double period);
+    void processInput();
+    void publishSnapshot(double period);
+};
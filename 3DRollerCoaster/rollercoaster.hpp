@@ -1,6 +1,10 @@
 #pragma once
 #include "model.hpp"
+#include "gpu_rails.hpp"
 #include "path.hpp"
+#include "job_system.hpp"
+#include "track_bundle.hpp"
+#include "track_generator.hpp"
 #include <glm/glm.hpp>
 #include <vector>
 
@@ -11,10 +15,25 @@ public:
         float trackWidth,
         float railThickness,
         int samples,
+        TrackTessellation tessellation,
         unsigned int railTexID,
-        unsigned int woodTexID
+        unsigned int woodTexID,
+        JobSystem* jobSystem = nullptr,  // ako postoji, staza se generise paralelno
+        const TrackBundle* bundle = nullptr,    // ako postoji, geometrija se ne generise nego ide iz pecene staze u GL bafere
+        bool railsOnGpu = false                 // sine se izvlace u sejderu (GpuRails), mesh sina ostaje prazan
     );
 
+    // za ponovno generisanje staze nad novom putanjom (TrackRebuilder):
+    // generator sa istim dimenzijama, mesh-evi od gotove geometrije i zamena postojecih (stari se brisu sa GPU)
+    TrackGenerator makeGenerator(Path* newPath) const;
+    std::vector<Mesh> makeMeshes(TrackGeometry& geometry, bool uploadNow) const;
+    void replaceMeshes(std::vector<Mesh>& newMeshes, Path* newPath);
+    // uz replaceMeshes kad su sine na GPU
+    void replaceRailSamples(const std::vector<RailSample>& samples);
+
+    bool hasGpuRails() const;
+    const GpuRails& getGpuRails() const;
+
 private:
     Path* path;
     float trackWidth;
@@ -22,8 +41,7 @@ private:
     unsigned int railTexID;
     unsigned int woodTexID;
     int samples;
-
-    void generateRails();
-    void generatePlanks();
-    void generateSleepers();
+    TrackTessellation tessellation;
+    bool railsOnGpu;
+    GpuRails gpuRails;
 };
@@ -0,0 +1,21 @@
+#pragma once
+#include "ride_state.hpp"
+
+const int MAX_PASSENGERS = 8;
+
+struct PassengerSnapshot {
+    bool isActive = false;
+    bool isSick = false;
+    bool isBeltOn = false;
+};
+
+// nepromenljivo stanje voznje posle jednog koraka simulacije (sim nit -> render nit)
+struct SceneSnapshot {
+    long long tick = 0;
+    double tickTime = 0.0;      // kada je korak objavljen (sekunde, steady_clock)
+    double tickPeriod = 0.0;    // realno vreme izmedju dva koraka (zavisi od brzine simulacije)
+    float prevT = 0.0f;         // polozaj kola u prethodnom i ovom koraku - render interpolira izmedju njih
+    float t = 0.0f;
+    RideState rideState = RideState::READY;
+    PassengerSnapshot passengers[MAX_PASSENGERS];
+};
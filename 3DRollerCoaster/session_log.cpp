@@ -0,0 +1,244 @@
+#include "session_log.hpp"
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const char SESSION_MAGIC[4] = { 'R', 'C', 'S', 'L' };
+    const uint32_t SESSION_VERSION = 3;
+    const uint8_t TAG_FRAME = 'F';
+    const uint8_t TAG_END = 'E';
+
+    template <typename T>
+    void writeValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream& file, T& value) {
+        return (bool)file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    // string: duzina pa bajtovi (bez nule na kraju)
+    void writeString(std::ofstream& file, const std::string& value) {
+        writeValue(file, (uint32_t)value.size());
+        file.write(value.data(), value.size());
+    }
+
+    bool readString(std::ifstream& file, std::string& value) {
+        uint32_t size = 0;
+        // putanja duza od 4 KB znaci ostecen fajl
+        if (!readValue(file, size) || size > 4096)
+            return false;
+        value.resize(size);
+        return size == 0 || (bool)file.read(&value[0], size);
+    }
+
+    // zaglavlje i kraj se upisuju polje po polje (bez bajtova poravnanja), pa je isti snimak isti fajl
+    void writeConfig(std::ofstream& file, const SessionConfig& config) {
+        writeValue(file, config.width);
+        writeValue(file, config.height);
+        writeValue(file, config.frameMode);
+        writeValue(file, config.timeScale);
+        writeValue(file, config.depthTest);
+        writeValue(file, config.cullFace);
+        writeValue(file, config.occlusionCulling);
+        writeValue(file, config.dynamicResolution);
+        writeValue(file, config.fpCamera);
+        writeValue(file, config.firstMouse);
+        writeValue(file, config.lastX);
+        writeValue(file, config.lastY);
+        writeValue(file, config.yaw);
+        writeValue(file, config.pitch);
+        writeValue(file, config.cameraPos);
+        writeValue(file, config.cameraFront);
+        writeString(file, config.trackFile);
+        writeString(file, config.bundleFile);
+        writeValue(file, config.gpuRails);
+    }
+
+    bool readConfig(std::ifstream& file, SessionConfig& config) {
+        return readValue(file, config.width) && readValue(file, config.height) && readValue(file, config.frameMode) &&
+            readValue(file, config.timeScale) && readValue(file, config.depthTest) && readValue(file, config.cullFace) &&
+            readValue(file, config.occlusionCulling) && readValue(file, config.dynamicResolution) &&
+            readValue(file, config.fpCamera) && readValue(file, config.firstMouse) && readValue(file, config.lastX) &&
+            readValue(file, config.lastY) && readValue(file, config.yaw) && readValue(file, config.pitch) &&
+            readValue(file, config.cameraPos) && readValue(file, config.cameraFront) &&
+            readString(file, config.trackFile) && readString(file, config.bundleFile) && readValue(file, config.gpuRails);
+    }
+
+    void writeResult(std::ofstream& file, const SessionResult& result) {
+        writeValue(file, result.frames);
+        writeValue(file, result.ticks);
+        writeValue(file, result.t);
+        writeValue(file, result.rideState);
+        writeValue(file, result.yaw);
+        writeValue(file, result.pitch);
+        writeValue(file, result.cameraPos);
+    }
+
+    bool readResult(std::ifstream& file, SessionResult& result) {
+        return readValue(file, result.frames) && readValue(file, result.ticks) && readValue(file, result.t) &&
+            readValue(file, result.rideState) && readValue(file, result.yaw) && readValue(file, result.pitch) &&
+            readValue(file, result.cameraPos);
+    }
+}
+
+bool SessionResult::operator==(const SessionResult& other) const {
+    return frames == other.frames && ticks == other.ticks && t == other.t && rideState == other.rideState &&
+        yaw == other.yaw && pitch == other.pitch && cameraPos == other.cameraPos;
+}
+
+void SessionResult::print(const char* name) const {
+    std::cout << "  " << name << ": frejmova " << frames << ", koraka " << ticks << ", t " << t
+        << ", stanje voznje " << rideState << ", kamera (" << cameraPos.x << ", " << cameraPos.y << ", " << cameraPos.z
+        << ") yaw " << yaw << " pitch " << pitch << std::endl;
+}
+
+bool SessionRecorder::open(const std::string& path, const SessionConfig& config) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "Snimak sesije: ne moze da se otvori " << path << std::endl;
+        return false;
+    }
+    file.write(SESSION_MAGIC, sizeof(SESSION_MAGIC));
+    writeValue(file, SESSION_VERSION);
+    writeConfig(file, config);
+    frames = 0;
+    frameEvents.clear();
+    return true;
+}
+
+bool SessionRecorder::isOpen() const {
+    return file.is_open();
+}
+
+void SessionRecorder::recordEvent(const InputEvent& event) {
+    // vise od 65535 dogadjaja u jednom frejmu ne staje u zapis frejma
+    if (!isOpen() || frameEvents.size() >= 0xFFFF) return;
+    frameEvents.push_back(event);
+}
+
+void SessionRecorder::endFrame(float dt, uint8_t heldKeys) {
+    if (!isOpen()) return;
+    // frejm: tag, dt, drzani tasteri, broj dogadjaja pa dogadjaji (samo polja koja tip koristi)
+    writeValue(file, TAG_FRAME);
+    writeValue(file, dt);
+    writeValue(file, heldKeys);
+    writeValue(file, (uint16_t)frameEvents.size());
+    for (const InputEvent& event : frameEvents) {
+        writeValue(file, (uint8_t)event.type);
+        if (event.type == InputEventType::KEY_PRESS) {
+            writeValue(file, (int32_t)event.key);
+        }
+        else {
+            writeValue(file, event.x);
+            writeValue(file, event.y);
+        }
+    }
+    frameEvents.clear();
+    frames++;
+}
+
+void SessionRecorder::close(const SessionResult& result) {
+    if (!isOpen()) return;
+    writeValue(file, TAG_END);
+    writeResult(file, result);
+    file.close();
+    std::cout << "Snimak sesije: upisano " << frames << " frejmova" << std::endl;
+}
+
+bool SessionReplay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "Reprodukcija sesije: ne moze da se otvori " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, SESSION_MAGIC, sizeof(magic)) != 0 ||
+        !readValue(file, version) || version != SESSION_VERSION || !readConfig(file, config)) {
+        std::cout << "Reprodukcija sesije: " << path << " nije snimak sesije (ili je druga verzija)" << std::endl;
+        return false;
+    }
+
+    frames.clear();
+    events.clear();
+    nextFrameIndex = 0;
+    uint8_t tag = 0;
+    while (readValue(file, tag)) {
+        if (tag == TAG_END) {
+            if (!readResult(file, expected))
+                break;
+            std::cout << "Reprodukcija sesije: ucitano " << frames.size() << " frejmova, " << events.size() << " dogadjaja" << std::endl;
+            return true;
+        }
+        if (tag != TAG_FRAME)
+            break;
+
+        Frame frame;
+        uint16_t count = 0;
+        if (!readValue(file, frame.dt) || !readValue(file, frame.heldKeys) || !readValue(file, count))
+            break;
+        frame.firstEvent = (uint32_t)events.size();
+        frame.eventCount = count;
+
+        bool ok = true;
+        for (uint16_t i = 0; i < count && ok; i++) {
+            InputEvent event;
+            uint8_t type = 0;
+            ok = readValue(file, type);
+            event.type = (InputEventType)type;
+            if (event.type == InputEventType::KEY_PRESS) {
+                int32_t key = 0;
+                ok = ok && readValue(file, key);
+                event.key = key;
+            }
+            else {
+                ok = ok && readValue(file, event.x) && readValue(file, event.y);
+            }
+            events.push_back(event);
+        }
+        if (!ok)
+            break;
+        frames.push_back(frame);
+    }
+
+    // snimak bez kraja (npr. program je pao tokom snimanja) ne moze da posluzi za proveru
+    std::cout << "Reprodukcija sesije: " << path << " je nepotpun" << std::endl;
+    return false;
+}
+
+const SessionConfig& SessionReplay::getConfig() const {
+    return config;
+}
+
+const SessionResult& SessionReplay::getExpectedResult() const {
+    return expected;
+}
+
+int64_t SessionReplay::getFrameCount() const {
+    return (int64_t)frames.size();
+}
+
+bool SessionReplay::isFinished() const {
+    return nextFrameIndex >= frames.size();
+}
+
+float SessionReplay::nextFrame(uint8_t& heldKeys, std::vector<InputEvent>& frameEvents) {
+    frameEvents.clear();
+    if (isFinished()) {
+        heldKeys = 0;
+        return 0.0f;
+    }
+    const Frame& frame = frames[nextFrameIndex++];
+    heldKeys = frame.heldKeys;
+    // vreme nastanka je trenutak reprodukcije (da statistika kasnjenja ima smisla)
+    int64_t now = inputTimestampNow();
+    for (uint32_t i = 0; i < frame.eventCount; i++) {
+        InputEvent event = events[frame.firstEvent + i];
+        event.timestamp = now;
+        frameEvents.push_back(event);
+    }
+    return frame.dt;
+}
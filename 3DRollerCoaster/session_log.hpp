@@ -0,0 +1,92 @@
+#pragma once
+#include "input_event.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+    snimak sesije (binarni log) za ponovljive benchmark-e:
+        - zaglavlje: pocetna konfiguracija (prozor, toggle-ovi, kamera, brzina simulacije) i staza
+          (--track, --bundle, --gpu-rails), jer snimak vazi samo za istu stazu
+        - za svaki frejm: dt, tasteri za setanje kamere koji su bili drzani i dogadjaji iz GLFW callback-ova
+        - kraj: konacno stanje (koraci simulacije, t, stanje voznje, kamera) za proveru pri reprodukciji
+    simulacija tokom snimanja i reprodukcije ide u lockstep-u sa frejmovima (RideSimulation::stepFrame),
+    pa isti niz dt-ova i dogadjaja daje tacno iste korake
+*/
+
+// tasteri koji se citaju sa glfwGetKey svaki frejm (setanje kamere), kao bitovi
+enum HeldKey : uint8_t {
+    HELD_LEFT = 1 << 0,
+    HELD_RIGHT = 1 << 1,
+    HELD_UP = 1 << 2,
+    HELD_DOWN = 1 << 3
+};
+
+struct SessionConfig {
+    int32_t width = 0, height = 0;
+    int32_t frameMode = 0;
+    float timeScale = 1.0f;
+    uint8_t depthTest = 1, cullFace = 1, occlusionCulling = 1, dynamicResolution = 0, fpCamera = 1, firstMouse = 1;
+    float lastX = 0.0f, lastY = 0.0f;
+    float yaw = 0.0f, pitch = 0.0f;
+    glm::vec3 cameraPos = glm::vec3(0.0f);
+    glm::vec3 cameraFront = glm::vec3(0.0f);
+    std::string trackFile;     // prazno: ugradjena staza
+    std::string bundleFile;
+    uint8_t gpuRails = 0;
+};
+
+struct SessionResult {
+    int64_t frames = 0;
+    int64_t ticks = 0;
+    float t = 0.0f;
+    int32_t rideState = 0;
+    float yaw = 0.0f, pitch = 0.0f;
+    glm::vec3 cameraPos = glm::vec3(0.0f);
+
+    bool operator==(const SessionResult& other) const;
+    void print(const char* name) const;
+};
+
+class SessionRecorder {
+public:
+    bool open(const std::string& path, const SessionConfig& config);
+    bool isOpen() const;
+    // dogadjaj koji je u ovom frejmu stigao iz callback-a
+    void recordEvent(const InputEvent& event);
+    // upisuje frejm sa svim dogadjajima snimljenim od prethodnog endFrame
+    void endFrame(float dt, uint8_t heldKeys);
+    void close(const SessionResult& result);
+
+private:
+    std::ofstream file;
+    std::vector<InputEvent> frameEvents;
+    int64_t frames = 0;
+};
+
+class SessionReplay {
+public:
+    bool load(const std::string& path);
+    const SessionConfig& getConfig() const;
+    const SessionResult& getExpectedResult() const;
+    int64_t getFrameCount() const;
+    bool isFinished() const;
+    // sledeci snimljeni frejm: vraca dt, puni drzane tastere i dogadjaje
+    float nextFrame(uint8_t& heldKeys, std::vector<InputEvent>& events);
+
+private:
+    struct Frame {
+        float dt;
+        uint8_t heldKeys;
+        uint32_t firstEvent;
+        uint32_t eventCount;
+    };
+
+    SessionConfig config;
+    SessionResult expected;
+    std::vector<Frame> frames;
+    std::vector<InputEvent> events;
+    size_t nextFrameIndex = 0;
+};
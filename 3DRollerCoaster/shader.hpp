@@ -8,14 +8,21 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 
 class Shader
 {
 public:
     unsigned int ID;
     // constructor generates the shader on the fly
+    // defines are injected right after the #version line (one "#define X" per line)
     // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath)
+    Shader(const char* vertexPath, const char* fragmentPath, const std::string& defines = "")
     {
         // 1. retrieve the vertex/fragment source code from filePath
         std::string vertexCode;
@@ -38,16 +45,30 @@ public:
             vShaderFile.close();
             fShaderFile.close();
             // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
+            vertexCode = injectDefines(vShaderStream.str(), defines);
+            fragmentCode = injectDefines(fShaderStream.str(), defines);
         }
         catch (std::ifstream::failure& e)
         {
             std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
         }
+
+        // 2. try the program binary cache first, the key covers sources, defines and the driver
+        ID = glCreateProgram();
+        std::string cachePath = getCachePath(vertexCode, fragmentCode, defines);
+        auto start = std::chrono::steady_clock::now();
+        double savedMs = 0.0;
+        if (loadProgramBinary(cachePath, savedMs))
+        {
+            double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            totalSavedMs() += savedMs - loadMs;
+            std::cout << "SHADER::CACHE::HIT " << vertexPath << " + " << fragmentPath << " loaded in " << loadMs << " ms (saved ~" << savedMs - loadMs << " ms)" << std::endl;
+            return;
+        }
+
+        // 3. compile shaders
         const char* vShaderCode = vertexCode.c_str();
         const char* fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
         unsigned int vertex, fragment;
         // vertex shader
         vertex = glCreateShader(GL_VERTEX_SHADER);
@@ -60,15 +81,28 @@ public:
         glCompileShader(fragment);
         checkCompileErrors(fragment, "FRAGMENT");
         // shader Program
-        ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
+        if (programBinarySupported())
+            glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
+        bool linked = checkCompileErrors(ID, "PROGRAM");
         // delete the shaders as they're linked into our program now and no longer necessary
+        glDetachShader(ID, vertex);
+        glDetachShader(ID, fragment);
         glDeleteShader(vertex);
         glDeleteShader(fragment);
 
+        double compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (linked)
+            saveProgramBinary(cachePath, compileMs);
+        std::cout << "SHADER::CACHE::MISS " << vertexPath << " + " << fragmentPath << " compiled in " << compileMs << " ms" << std::endl;
+    }
+    // total compile time saved by the program binary cache during this launch
+    // ------------------------------------------------------------------------
+    static double getTotalSavedMs()
+    {
+        return totalSavedMs();
     }
     // activate the shader
     // ------------------------------------------------------------------------
@@ -136,9 +170,138 @@ public:
     }
 
 private:
+    // binary cache file layout: header followed by the driver's program binary
+    // ------------------------------------------------------------------------
+    struct CacheHeader
+    {
+        char magic[4];          // "RCPB"
+        uint32_t version;
+        uint32_t binaryFormat;
+        uint32_t binaryLength;
+        double compileMs;       // how long the source compilation took when the entry was created
+    };
+    static constexpr uint32_t CACHE_VERSION = 1;
+
+    static double& totalSavedMs()
+    {
+        static double saved = 0.0;
+        return saved;
+    }
+    // ------------------------------------------------------------------------
+    static bool programBinarySupported()
+    {
+        if (!GLEW_ARB_get_program_binary)
+            return false;
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+    // ------------------------------------------------------------------------
+    static std::string injectDefines(const std::string& code, const std::string& defines)
+    {
+        if (defines.empty())
+            return code;
+        // #version has to stay the first line of the shader
+        size_t lineEnd = code.find('\n');
+        if (code.compare(0, 8, "#version") != 0 || lineEnd == std::string::npos)
+            return defines + "\n" + code;
+        return code.substr(0, lineEnd + 1) + defines + "\n" + code.substr(lineEnd + 1);
+    }
+    // 64-bit FNV-1a
+    // ------------------------------------------------------------------------
+    static uint64_t hashString(const std::string& text, uint64_t hash = 14695981039346656037ull)
+    {
+        for (unsigned char c : text)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        // separator so that ("ab", "c") and ("a", "bc") hash differently
+        hash ^= 0xff;
+        hash *= 1099511628211ull;
+        return hash;
+    }
+    // ------------------------------------------------------------------------
+    static std::string getCachePath(const std::string& vertexCode, const std::string& fragmentCode, const std::string& defines)
+    {
+        uint64_t hash = hashString(vertexCode);
+        hash = hashString(fragmentCode, hash);
+        hash = hashString(defines, hash);
+        // a binary is only valid for the driver that produced it
+        const GLubyte* driverStrings[] = { glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION) };
+        for (const GLubyte* driverString : driverStrings)
+            hash = hashString(driverString ? reinterpret_cast<const char*>(driverString) : "", hash);
+
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+        return std::string("shader_cache/") + name;
+    }
+    // ------------------------------------------------------------------------
+    bool loadProgramBinary(const std::string& cachePath, double& compileMs)
+    {
+        if (!programBinarySupported())
+            return false;
+        std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return false;
+        std::streamoff fileSize = file.tellg();
+        file.seekg(0);
+
+        CacheHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, "RCPB", 4) != 0 || header.version != CACHE_VERSION)
+            return false;
+        // the length comes from disk: a truncated or corrupt entry must not drive the allocation
+        if (header.binaryLength == 0 || (std::streamoff)header.binaryLength != fileSize - (std::streamoff)sizeof(header))
+        {
+            std::cout << "SHADER::CACHE::CORRUPT " << cachePath << std::endl;
+            return false;
+        }
+        std::vector<char> binary(header.binaryLength);
+        if (!file.read(binary.data(), binary.size()))
+            return false;
+
+        glProgramBinary(ID, header.binaryFormat, binary.data(), header.binaryLength);
+        GLint success = GL_FALSE;
+        glGetProgramiv(ID, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            // driver rejected the binary (e.g. it was updated), fall back to the sources
+            std::cout << "SHADER::CACHE::REJECTED " << cachePath << std::endl;
+            return false;
+        }
+        compileMs = header.compileMs;
+        return true;
+    }
+    // ------------------------------------------------------------------------
+    void saveProgramBinary(const std::string& cachePath, double compileMs)
+    {
+        if (!programBinarySupported())
+            return;
+        GLint length = 0;
+        glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(ID, length, NULL, &format, binary.data());
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+        std::ofstream file(cachePath, std::ios::binary);
+        if (!file.is_open())
+        {
+            std::cout << "SHADER::CACHE::WRITE_FAILED " << cachePath << std::endl;
+            return;
+        }
+        CacheHeader header = { { 'R', 'C', 'P', 'B' }, CACHE_VERSION, format, (uint32_t)length, compileMs };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), binary.size());
+    }
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
-    void checkCompileErrors(GLuint shader, std::string type)
+    bool checkCompileErrors(GLuint shader, std::string type)
     {
         GLint success;
         GLchar infoLog[1024];
@@ -160,7 +323,7 @@ private:
                 std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         }
+        return success != 0;
     }
 };
 #endif
-
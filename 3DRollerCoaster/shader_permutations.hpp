@@ -0,0 +1,56 @@
+#ifndef SHADER_PERMUTATIONS_H
+#define SHADER_PERMUTATIONS_H
+
+#include "shader.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+// set of programs compiled from the same sources, one per combination of feature #defines.
+// features are addressed by bit: feature i is enabled in every variant whose mask has bit i set,
+// so a draw picks its program with get(mask) instead of branching on uniforms per fragment.
+class ShaderPermutations
+{
+public:
+    // every combination is compiled up front so that selecting a variant never stalls a frame
+    // ------------------------------------------------------------------------
+    ShaderPermutations(const char* vertexPath, const char* fragmentPath, const std::vector<std::string>& features)
+        : features(features)
+    {
+        unsigned int count = 1u << features.size();
+        for (unsigned int mask = 0; mask < count; mask++)
+            variants.push_back(std::make_unique<Shader>(vertexPath, fragmentPath, getDefines(mask)));
+    }
+    // program for the given feature mask
+    // ------------------------------------------------------------------------
+    Shader& get(unsigned int mask)
+    {
+        return *variants[mask & (variants.size() - 1)];
+    }
+    // runs func with every variant bound, used for uniforms shared by all variants (camera, light...)
+    // ------------------------------------------------------------------------
+    template <typename Func>
+    void forEach(Func func)
+    {
+        for (auto& variant : variants)
+        {
+            variant->use();
+            func(*variant);
+        }
+    }
+
+private:
+    std::vector<std::string> features;
+    std::vector<std::unique_ptr<Shader>> variants;
+
+    std::string getDefines(unsigned int mask) const
+    {
+        std::string defines;
+        for (size_t i = 0; i < features.size(); i++)
+            if (mask & (1u << i))
+                defines += "#define " + features[i] + "\n";
+        return defines;
+    }
+};
+#endif
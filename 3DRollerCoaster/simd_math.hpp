@@ -0,0 +1,73 @@
+#pragma once
+#include <cmath>
+
+// SSE2 postoji na svakom x64 procesoru (MSVC x64 ga uvek ukljucuje), na ostalim platformama ide skalarno
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_MATH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/*
+    sin i cos za 4 float-a odjednom:
+        - svodjenje na [-pi/4, pi/4] u tri koraka (Cody-Waite) i polinomi iz Cephes sinf/cosf,
+          relativna greska oko 1e-7 za |x| do nekoliko hiljada
+        - ulaz i izlaz su nizovi od 4 float-a (ne moraju biti poravnati)
+*/
+inline void sincos4(const float* x, float* sinOut, float* cosOut)
+{
+#ifdef SIMD_MATH_SSE2
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128i four = _mm_set1_epi32(4);
+
+    __m128 v = _mm_loadu_ps(x);
+    // sin je neparna funkcija: znak ulaza se pamti, radi se sa |x|
+    __m128 signSin = _mm_and_ps(v, signMask);
+    v = _mm_andnot_ps(signMask, v);
+
+    // oktant: j = (int)(x * 4 / pi), zaokruzeno na paran
+    __m128i j = _mm_cvttps_epi32(_mm_mul_ps(v, _mm_set1_ps(1.27323954473516f)));
+    j = _mm_add_epi32(j, one);
+    j = _mm_and_si128(j, _mm_set1_epi32(~1));
+    __m128 y = _mm_cvtepi32_ps(j);
+
+    // znak i izbor polinoma po oktantu
+    __m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, four), 29));
+    __m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, two), _mm_setzero_si128()));
+    __m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, two), four), 29));
+    signSin = _mm_xor_ps(signSin, swapSignSin);
+
+    // x - j * pi/4 u tri dela da se ne izgubi tacnost
+    v = _mm_add_ps(v, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+    v = _mm_add_ps(v, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+    v = _mm_add_ps(v, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+    __m128 z = _mm_mul_ps(v, v);
+
+    // cos polinom na [-pi/4, pi/4]
+    __m128 c = _mm_set1_ps(2.443315711809948e-5f);
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(-1.388731625493765e-3f));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+    c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+    c = _mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    c = _mm_add_ps(c, _mm_set1_ps(1.0f));
+
+    // sin polinom na [-pi/4, pi/4]
+    __m128 s = _mm_set1_ps(-1.9515295891e-4f);
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(8.3321608736e-3f));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(-1.6666654611e-1f));
+    s = _mm_mul_ps(_mm_mul_ps(s, z), v);
+    s = _mm_add_ps(s, v);
+
+    // u neparnim oktantima sin i cos menjaju uloge
+    __m128 sinResult = _mm_or_ps(_mm_and_ps(polyMask, s), _mm_andnot_ps(polyMask, c));
+    __m128 cosResult = _mm_or_ps(_mm_and_ps(polyMask, c), _mm_andnot_ps(polyMask, s));
+    _mm_storeu_ps(sinOut, _mm_xor_ps(sinResult, signSin));
+    _mm_storeu_ps(cosOut, _mm_xor_ps(cosResult, signCos));
+#else
+    for (int i = 0; i < 4; i++) {
+        sinOut[i] = std::sin(x[i]);
+        cosOut[i] = std::cos(x[i]);
+    }
+#endif
+}
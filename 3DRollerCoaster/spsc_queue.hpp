@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/*
+    lock-free red fiksnog kapaciteta za jednog proizvodjaca i jednog potrosaca (ring buffer):
+        - nema alokacija posle konstrukcije, push/pop su par atomskih load/store operacija
+        - glava i rep su na posebnim kes linijama da proizvodjac i potrosac ne bi "otimali" istu liniju
+    Capacity mora biti stepen dvojke
+*/
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity mora biti stepen dvojke");
+
+public:
+    // proizvodjac: vraca false ako je red pun (dogadjaj se odbacuje, ne cekamo)
+    bool push(const T& item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - cachedHead == Capacity) {
+            cachedHead = headIndex.load(std::memory_order_acquire);
+            if (tail - cachedHead == Capacity)
+                return false;
+        }
+        items[tail & (Capacity - 1)] = item;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // potrosac: vraca false ako je red prazan
+    bool pop(T& item) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tailIndex.load(std::memory_order_acquire);
+            if (head == cachedTail)
+                return false;
+        }
+        item = items[head & (Capacity - 1)];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> items;
+
+    alignas(64) std::atomic<size_t> headIndex{ 0 };
+    size_t cachedTail = 0;      // potrosaceva kopija repa
+
+    alignas(64) std::atomic<size_t> tailIndex{ 0 };
+    size_t cachedHead = 0;      // proizvodjaceva kopija glave
+};
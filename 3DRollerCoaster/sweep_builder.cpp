@@ -0,0 +1,152 @@
+#include "sweep_builder.hpp"
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+
+// ================= PRESECI =================
+SweepProfile SweepProfile::polygon(const std::vector<glm::vec2>& outline, const std::vector<unsigned int>& capTriangles)
+{
+    SweepProfile profile;
+    profile.outline = outline;
+    profile.capTriangles = capTriangles;
+    for (size_t i = 0; i < outline.size(); i++) {
+        glm::vec2 a = outline[i];
+        glm::vec2 b = outline[(i + 1) % outline.size()];
+        glm::vec2 direction = glm::normalize(b - a);
+        // spoljasnja normala je desno od smera obilaska
+        glm::vec2 normal(direction.y, -direction.x);
+
+        int first = (int)profile.positions.size();
+        profile.positions.push_back(a);
+        profile.positions.push_back(b);
+        profile.normals.push_back(normal);
+        profile.normals.push_back(normal);
+        profile.u.push_back(0.0f);
+        profile.u.push_back(1.0f);
+        profile.edges.push_back(glm::ivec2(first, first + 1));
+    }
+    return profile;
+}
+
+SweepProfile SweepProfile::box(float halfWidth, float halfHeight)
+{
+    return polygon(
+        { { -halfWidth, -halfHeight }, { halfWidth, -halfHeight }, { halfWidth, halfHeight }, { -halfWidth, halfHeight } },
+        { 0, 1, 2, 0, 2, 3 });
+}
+
+SweepProfile SweepProfile::iBeam(float halfWidth, float halfHeight, float flangeThickness, float halfWebThickness)
+{
+    float w = halfWidth, h = halfHeight, t = flangeThickness, web = halfWebThickness;
+    // od donjeg levog ugla: donja pojasnica, rebro, gornja pojasnica
+    return polygon(
+        { { -w, -h }, { w, -h }, { w, -h + t }, { web, -h + t }, { web, h - t }, { w, h - t },
+          { w, h }, { -w, h }, { -w, h - t }, { -web, h - t }, { -web, -h + t }, { -w, -h + t } },
+        { 0, 1, 2, 0, 2, 11,        // donja pojasnica
+          10, 3, 4, 10, 4, 9,       // rebro
+          8, 5, 6, 8, 6, 7 });      // gornja pojasnica
+}
+
+SweepProfile SweepProfile::tube(float radius, int segments)
+{
+    SweepProfile profile;
+    for (int i = 0; i <= segments; i++) {
+        float angle = 2.0f * glm::pi<float>() * i / segments;
+        glm::vec2 direction(std::cos(angle), std::sin(angle));
+        profile.positions.push_back(direction * radius);
+        profile.normals.push_back(direction);
+        profile.u.push_back(float(i) / segments);
+        if (i < segments) {
+            profile.edges.push_back(glm::ivec2(i, i + 1));
+            profile.outline.push_back(direction * radius);
+        }
+    }
+    // lepeza iz prvog verteksa (presek je konveksan)
+    for (int i = 1; i + 1 < segments; i++) {
+        profile.capTriangles.push_back(0);
+        profile.capTriangles.push_back(i);
+        profile.capTriangles.push_back(i + 1);
+    }
+    return profile;
+}
+
+// ================= IZVLACENJE =================
+SweepBuilder::SweepBuilder(const SweepProfile& profile) :
+profile(profile)
+{
+}
+
+size_t SweepBuilder::getVertexCount(size_t rings, bool caps) const
+{
+    return rings * profile.positions.size() + (caps ? 2 * profile.outline.size() : 0);
+}
+
+size_t SweepBuilder::getIndexCount(size_t rings, bool caps) const
+{
+    size_t segments = rings > 0 ? rings - 1 : 0;
+    return segments * profile.edges.size() * 6 + (caps ? 2 * profile.capTriangles.size() : 0);
+}
+
+void SweepBuilder::writeRings(const SweepFrame* frames, size_t first, size_t count, Vertex* vertices) const
+{
+    size_t ringSize = profile.positions.size();
+    Vertex* out = vertices + first * ringSize;
+    for (size_t ring = 0; ring < count; ring++) {
+        const SweepFrame& frame = frames[ring];
+        for (size_t i = 0; i < ringSize; i++) {
+            glm::vec2 p = profile.positions[i];
+            glm::vec2 n = profile.normals[i];
+            *out++ = {
+                frame.position + frame.normal * p.x + frame.binormal * p.y,
+                frame.normal * n.x + frame.binormal * n.y,
+                glm::vec2(profile.u[i], frame.v)
+            };
+        }
+    }
+}
+
+void SweepBuilder::writeSegments(size_t first, size_t count, unsigned int baseVertex, unsigned int* indices) const
+{
+    unsigned int ringSize = (unsigned int)profile.positions.size();
+    unsigned int* out = indices + first * profile.edges.size() * 6;
+    for (size_t segment = first; segment < first + count; segment++) {
+        unsigned int ring0 = baseVertex + (unsigned int)segment * ringSize;
+        unsigned int ring1 = ring0 + ringSize;
+        for (const glm::ivec2& edge : profile.edges) {
+            // a0, b0, b1, a1: suprotno od kazaljke gledano spolja (presek je suprotno od kazaljke, tangenta ide napred)
+            unsigned int a0 = ring0 + edge.x, b0 = ring0 + edge.y;
+            unsigned int a1 = ring1 + edge.x, b1 = ring1 + edge.y;
+            unsigned int quad[6] = { a0, b0, b1, a0, b1, a1 };
+            for (unsigned int index : quad)
+                *out++ = index;
+        }
+    }
+}
+
+void SweepBuilder::writeCaps(const SweepFrame& first, const SweepFrame& last, size_t rings, unsigned int baseVertex,
+    Vertex* vertices, unsigned int* indices) const
+{
+    size_t outlineSize = profile.outline.size();
+    Vertex* out = vertices + rings * profile.positions.size();
+    unsigned int* outIndices = indices + getIndexCount(rings, false);
+    unsigned int capBase = baseVertex + (unsigned int)(rings * profile.positions.size());
+
+    for (int cap = 0; cap < 2; cap++) {
+        const SweepFrame& frame = cap == 0 ? first : last;
+        // pocetni poklopac gleda unazad, krajnji unapred (tangenta = normala x binormala)
+        glm::vec3 tangent = glm::cross(frame.normal, frame.binormal);
+        glm::vec3 normal = cap == 0 ? -tangent : tangent;
+        for (size_t i = 0; i < outlineSize; i++) {
+            glm::vec2 p = profile.outline[i];
+            *out++ = { frame.position + frame.normal * p.x + frame.binormal * p.y, normal, p };
+        }
+        // gledano unazad obilazak se obrce
+        for (size_t i = 0; i < profile.capTriangles.size(); i += 3) {
+            unsigned int a = profile.capTriangles[i], b = profile.capTriangles[i + 1], c = profile.capTriangles[i + 2];
+            *outIndices++ = capBase + a;
+            *outIndices++ = capBase + (cap == 0 ? c : b);
+            *outIndices++ = capBase + (cap == 0 ? b : c);
+        }
+        capBase += (unsigned int)outlineSize;
+    }
+}
+
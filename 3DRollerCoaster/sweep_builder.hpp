@@ -0,0 +1,58 @@
+#pragma once
+#include "mesh.hpp"
+#include <glm/glm.hpp>
+#include <vector>
+
+// presek koji se izvlaci duz putanje, u ravni (x = normala okvira, y = binormala), obilazak suprotno od kazaljke
+struct SweepProfile {
+    // verteksi jednog prstena: pozicija, normala i u koordinata teksture
+    std::vector<glm::vec2> positions;
+    std::vector<glm::vec2> normals;
+    std::vector<float> u;
+    // parovi verteksa prstena koji sa sledecim prstenom cine cetvorougao (strana izvlacenja)
+    std::vector<glm::ivec2> edges;
+    // obod preseka i trouglovi poklopca nad njim (suprotno od kazaljke)
+    std::vector<glm::vec2> outline;
+    std::vector<unsigned int> capTriangles;
+
+    // mnogougao sa ostrim ivicama (svaka strana ima svoja dva verteksa i svoju normalu)
+    static SweepProfile polygon(const std::vector<glm::vec2>& outline, const std::vector<unsigned int>& capTriangles);
+    static SweepProfile box(float halfWidth, float halfHeight);
+    static SweepProfile iBeam(float halfWidth, float halfHeight, float flangeThickness, float halfWebThickness);
+    // glatka cev (normale u pravcu poluprecnika), prvi verteks je ponovljen na kraju zbog teksture
+    static SweepProfile tube(float radius, int segments);
+};
+
+// okvir u kome se postavlja prsten (normala, binormala i tangenta su desni ortonormirani sistem), v je duz izvlacenja
+struct SweepFrame {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec3 binormal;
+    float v;
+};
+
+/*
+    izvlacenje preseka duz niza okvira:
+        - susedni segmenti dele prsten (jedan prsten verteksa po okviru), strane izmedju prstenova su trake trouglova
+        - poklopci samo na pocetku i kraju (izmedju segmenata se ionako ne vide)
+        - raspored u baferu: prstenovi redom, pa pocetni i krajnji poklopac; indeksi: segmenti redom, pa poklopci
+    delovi su odvojeni (writeRings / writeSegments / writeCaps), da vise niti moze da pise razlicite opsege prstenova
+*/
+class SweepBuilder {
+public:
+    explicit SweepBuilder(const SweepProfile& profile);
+
+    size_t getVertexCount(size_t rings, bool caps) const;
+    size_t getIndexCount(size_t rings, bool caps) const;
+
+    // prstenovi [first, first + count) iz frames[0..count), verteksi celog izvlacenja pocinju od vertices
+    void writeRings(const SweepFrame* frames, size_t first, size_t count, Vertex* vertices) const;
+    // segmenti [first, first + count) (segment i spaja prsten i i i + 1), baseVertex je indeks prvog verteksa izvlacenja
+    void writeSegments(size_t first, size_t count, unsigned int baseVertex, unsigned int* indices) const;
+    // oba poklopca izvlacenja sa rings prstenova (poslednji okvir je kraj)
+    void writeCaps(const SweepFrame& first, const SweepFrame& last, size_t rings, unsigned int baseVertex,
+        Vertex* vertices, unsigned int* indices) const;
+
+private:
+    SweepProfile profile;
+};
@@ -0,0 +1,271 @@
+#include "track_bundle.hpp"
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static const char BUNDLE_MAGIC[4] = { 'R', 'C', 'T', 'B' };
+static const uint32_t BUNDLE_VERSION = 4;   // menja se i kad se promeni geometrija koju generator pravi
+static const uint64_t SECTION_ALIGNMENT = 64;
+
+enum SectionType : uint32_t {
+    SECTION_CONTROL_POINTS = 1,
+    SECTION_ARC_LENGTHS,
+    SECTION_T_AT_DISTANCE,
+    SECTION_POSE_POSITIONS,
+    SECTION_POSE_ORIENTATIONS,
+    SECTION_RAIL_VERTICES,
+    SECTION_RAIL_INDICES,
+    SECTION_PLANK_VERTICES,
+    SECTION_PLANK_INDICES,
+    SECTION_SLEEPER_VERTICES,
+    SECTION_SLEEPER_INDICES,
+    SECTION_COUNT = SECTION_SLEEPER_INDICES
+};
+
+// polja fiksne velicine i bez rupa izmedju njih, fajl se cita direktno kao struktura
+struct TrackBundleHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sectionCount;
+    uint32_t reserved;
+    // parametri putanje (kontrolne tacke su u svojoj sekciji)
+    float length, returnOffsetZ, baseHeight, amplitude;
+    int32_t hills;
+    float originX, originY, originZ;
+    float bankAngle;
+    // dimenzije staze
+    float trackWidth, railThickness;
+    int32_t samples;
+    float tolerance, maxSegmentLength;
+    uint64_t sectionTableChecksum;
+    uint64_t headerChecksum;        // svega iznad
+};
+
+struct TrackBundleSection {
+    uint32_t type;
+    uint32_t elementSize;
+    uint64_t offset;
+    uint64_t count;
+    uint64_t checksum;
+};
+
+// FNV-1a (kao hashBytes u benchmarks.cpp), ali po 8 bajtova, da provera ne bude sporija od citanja fajla
+static uint64_t checksum(const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t hash = 14695981039346656037ull;
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i * 8, 8);
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    for (size_t i = words * 8; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint32_t elementSizeOf(uint32_t type) {
+    switch (type) {
+    case SECTION_CONTROL_POINTS: return sizeof(TrackControlPoint);
+    case SECTION_ARC_LENGTHS:
+    case SECTION_T_AT_DISTANCE: return sizeof(float);
+    case SECTION_POSE_POSITIONS: return sizeof(glm::vec3);
+    case SECTION_POSE_ORIENTATIONS: return sizeof(glm::quat);
+    case SECTION_RAIL_VERTICES:
+    case SECTION_PLANK_VERTICES:
+    case SECTION_SLEEPER_VERTICES: return sizeof(Vertex);
+    default: return sizeof(unsigned int);
+    }
+}
+
+// ================= PISANJE =================
+TrackPartView TrackBundle::view(const TrackPart& part) {
+    TrackPartView result;
+    result.vertices = part.vertices.data();
+    result.vertexCount = part.vertices.size();
+    result.indices = part.indices.data();
+    result.indexCount = part.indices.size();
+    return result;
+}
+
+bool TrackBundle::write(const std::string& file, const Path& path, float trackWidth, float railThickness, int samples,
+    const TrackTessellation& tessellation, const TrackPartView parts[PART_COUNT]) {
+    PathParams params = path.getParams();
+    PathTables tables = path.getTables();
+
+    // sekcije redom po tipu
+    struct Payload { const void* data; uint64_t count; };
+    Payload payloads[SECTION_COUNT] = {
+        { params.controlPoints.data(), params.controlPoints.size() },
+        { tables.arcLengths, (uint64_t)tables.arcLengthSamples + 1 },
+        { tables.tAtDistance, (uint64_t)tables.arcLengthSamples + 1 },
+        { tables.posePositions, (uint64_t)tables.frameSamples + 1 },
+        { tables.poseOrientations, (uint64_t)tables.frameSamples + 1 },
+    };
+    for (int part = 0; part < PART_COUNT; part++) {
+        payloads[SECTION_RAIL_VERTICES - 1 + part * 2] = { parts[part].vertices, parts[part].vertexCount };
+        payloads[SECTION_RAIL_INDICES - 1 + part * 2] = { parts[part].indices, parts[part].indexCount };
+    }
+
+    std::vector<TrackBundleSection> sections(SECTION_COUNT);
+    uint64_t offset = sizeof(TrackBundleHeader) + sizeof(TrackBundleSection) * SECTION_COUNT;
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        TrackBundleSection& section = sections[i];
+        section.type = i + 1;
+        section.elementSize = elementSizeOf(section.type);
+        section.offset = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        section.count = payloads[i].count;
+        section.checksum = checksum(payloads[i].data, section.count * section.elementSize);
+        offset = section.offset + section.count * section.elementSize;
+    }
+
+    TrackBundleHeader header = {};
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = BUNDLE_VERSION;
+    header.sectionCount = SECTION_COUNT;
+    header.length = params.length;
+    header.returnOffsetZ = params.returnOffsetZ;
+    header.baseHeight = params.baseHeight;
+    header.amplitude = params.amplitude;
+    header.hills = params.hills;
+    header.originX = params.origin.x;
+    header.originY = params.origin.y;
+    header.originZ = params.origin.z;
+    header.bankAngle = params.bankAngle;
+    header.trackWidth = trackWidth;
+    header.railThickness = railThickness;
+    header.samples = samples;
+    header.tolerance = tessellation.tolerance;
+    header.maxSegmentLength = tessellation.maxSegmentLength;
+    header.sectionTableChecksum = checksum(sections.data(), sizeof(TrackBundleSection) * SECTION_COUNT);
+    header.headerChecksum = checksum(&header, offsetof(TrackBundleHeader, headerChecksum));
+
+    std::ofstream out(file, std::ios::binary);
+    if (!out) {
+        std::cout << "Pecena staza: ne moze da se upise " << file << std::endl;
+        return false;
+    }
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)sections.data(), sizeof(TrackBundleSection) * SECTION_COUNT);
+    uint64_t written = sizeof(header) + sizeof(TrackBundleSection) * SECTION_COUNT;
+    const char padding[SECTION_ALIGNMENT] = {};
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        out.write(padding, sections[i].offset - written);
+        out.write((const char*)payloads[i].data, sections[i].count * sections[i].elementSize);
+        written = sections[i].offset + sections[i].count * sections[i].elementSize;
+    }
+    if (!out) {
+        std::cout << "Pecena staza: greska pri upisu " << file << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ================= CITANJE =================
+bool TrackBundle::open(const std::string& file) {
+    close();
+    // fajla jos nema: nije greska, staza se pravi i peca
+    if (!mapped.open(file))
+        return false;
+
+    const uint8_t* data = mapped.data();
+    size_t size = mapped.size();
+    auto reject = [&](const char* reason) {
+        std::cout << "Pecena staza: " << file << " " << reason << ", pravi se ponovo" << std::endl;
+        close();
+        return false;
+    };
+
+    if (size < sizeof(TrackBundleHeader))
+        return reject("je prekratka");
+    const TrackBundleHeader* candidate = (const TrackBundleHeader*)data;
+    if (std::memcmp(candidate->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0)
+        return reject("nije pecena staza");
+    if (candidate->version != BUNDLE_VERSION)
+        return reject("je druga verzija");
+    if (candidate->headerChecksum != checksum(candidate, offsetof(TrackBundleHeader, headerChecksum)))
+        return reject("ima osteceno zaglavlje");
+    if (candidate->sectionCount != SECTION_COUNT ||
+        size < sizeof(TrackBundleHeader) + sizeof(TrackBundleSection) * SECTION_COUNT)
+        return reject("nema sve sekcije");
+
+    const TrackBundleSection* table = (const TrackBundleSection*)(data + sizeof(TrackBundleHeader));
+    if (candidate->sectionTableChecksum != checksum(table, sizeof(TrackBundleSection) * SECTION_COUNT))
+        return reject("ima ostecenu tabelu sekcija");
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        const TrackBundleSection& section = table[i];
+        if (section.type != i + 1 || section.elementSize != elementSizeOf(section.type) ||
+            section.offset % SECTION_ALIGNMENT != 0 || section.offset > size ||
+            section.count > (size - section.offset) / section.elementSize)
+            return reject("ima neispravnu sekciju");
+        if (section.checksum != checksum(data + section.offset, section.count * section.elementSize))
+            return reject("ima ostecene podatke");
+    }
+    // parovi tabela putanje moraju imati isti broj uzoraka (bar dva)
+    const TrackBundleSection& arcLengths = table[SECTION_ARC_LENGTHS - 1];
+    const TrackBundleSection& poses = table[SECTION_POSE_POSITIONS - 1];
+    if (arcLengths.count < 2 || table[SECTION_T_AT_DISTANCE - 1].count != arcLengths.count ||
+        poses.count < 2 || table[SECTION_POSE_ORIENTATIONS - 1].count != poses.count)
+        return reject("ima neispravne tabele putanje");
+
+    header = candidate;
+    sections = table;
+    return true;
+}
+
+void TrackBundle::close() {
+    mapped.close();
+    header = nullptr;
+    sections = nullptr;
+}
+
+bool TrackBundle::isOpen() const {
+    return header != nullptr;
+}
+
+bool TrackBundle::matches(const PathParams& params, float trackWidth, float railThickness, int samples,
+    const TrackTessellation& tessellation) const {
+    if (!header)
+        return false;
+    bool same = header->length == params.length && header->returnOffsetZ == params.returnOffsetZ &&
+        header->baseHeight == params.baseHeight && header->amplitude == params.amplitude &&
+        header->hills == params.hills && header->bankAngle == params.bankAngle &&
+        header->originX == params.origin.x && header->originY == params.origin.y && header->originZ == params.origin.z &&
+        header->trackWidth == trackWidth && header->railThickness == railThickness && header->samples == samples &&
+        header->tolerance == tessellation.tolerance && header->maxSegmentLength == tessellation.maxSegmentLength;
+
+    size_t count = 0;
+    const void* points = findSection(SECTION_CONTROL_POINTS, count);
+    return same && count == params.controlPoints.size() &&
+        (count == 0 || std::memcmp(points, params.controlPoints.data(), count * sizeof(TrackControlPoint)) == 0);
+}
+
+const void* TrackBundle::findSection(uint32_t type, size_t& count) const {
+    const TrackBundleSection& section = sections[type - 1];
+    count = (size_t)section.count;
+    return mapped.data() + section.offset;
+}
+
+PathTables TrackBundle::getPathTables() const {
+    size_t arcCount = 0, frameCount = 0;
+    PathTables tables;
+    tables.arcLengths = (const float*)findSection(SECTION_ARC_LENGTHS, arcCount);
+    tables.tAtDistance = (const float*)findSection(SECTION_T_AT_DISTANCE, arcCount);
+    tables.arcLengthSamples = (int)arcCount - 1;
+    tables.posePositions = (const glm::vec3*)findSection(SECTION_POSE_POSITIONS, frameCount);
+    tables.poseOrientations = (const glm::quat*)findSection(SECTION_POSE_ORIENTATIONS, frameCount);
+    tables.frameSamples = (int)frameCount - 1;
+    return tables;
+}
+
+TrackPartView TrackBundle::getPart(int part) const {
+    TrackPartView result;
+    result.vertices = (const Vertex*)findSection(SECTION_RAIL_VERTICES + part * 2, result.vertexCount);
+    result.indices = (const unsigned int*)findSection(SECTION_RAIL_INDICES + part * 2, result.indexCount);
+    return result;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "mapped_file.hpp"
+#include "path.hpp"
+#include "track_generator.hpp"
+#include <string>
+
+// pogled na geometriju jednog dela staze (u mapiranom fajlu ili u vektorima TrackPart / Mesh)
+struct TrackPartView {
+    const Vertex* vertices = nullptr;
+    size_t vertexCount = 0;
+    const unsigned int* indices = nullptr;
+    size_t indexCount = 0;
+};
+
+struct TrackBundleHeader;
+struct TrackBundleSection;
+
+/*
+    pecena staza (binarni fajl, --bundle): sve sto se inace racuna pri pokretanju
+        - zaglavlje: magic, verzija, parametri putanje i dimenzije staze od kojih je napravljena, checksum zaglavlja
+        - tabela sekcija: tip, velicina elementa, offset, broj elemenata i checksum svake sekcije
+        - sekcije (poravnate na 64 bajta): kontrolne tacke, tabele duzine luka i okvira putanje,
+          verteksi i indeksi sina, dasaka i potpornja
+    fajl se mapira u memoriju, pa se tabele putanje kopiraju a geometrija ide direktno iz mapiranih stranica
+    u GL bafere (bez parsiranja i bez medjukopije); fajl druge verzije ili sa losim checksum-om se odbacuje
+*/
+class TrackBundle {
+public:
+    // delovi staze, redosled mesh-eva u RollerCoaster-u
+    static const int PART_COUNT = 3;
+
+    static bool write(const std::string& file, const Path& path, float trackWidth, float railThickness, int samples,
+        const TrackTessellation& tessellation, const TrackPartView parts[PART_COUNT]);
+    static TrackPartView view(const TrackPart& part);
+
+    // mapira fajl i proverava zaglavlje i checksum svih sekcija
+    bool open(const std::string& file);
+    void close();
+    bool isOpen() const;
+
+    // da li je fajl napravljen od istih parametara (inace se staza pravi i peca ponovo)
+    bool matches(const PathParams& params, float trackWidth, float railThickness, int samples,
+        const TrackTessellation& tessellation) const;
+
+    PathTables getPathTables() const;
+    TrackPartView getPart(int part) const;
+
+private:
+    MappedFile mapped;
+    const TrackBundleHeader* header = nullptr;
+    const TrackBundleSection* sections = nullptr;
+
+    const void* findSection(uint32_t type, size_t& count) const;
+};
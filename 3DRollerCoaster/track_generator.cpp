@@ -0,0 +1,395 @@
+#include "track_generator.hpp"
+#include "sweep_builder.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // svaki kvadar ima 6 strana po 4 verteksa i 2 trougla
+    const int BOX_VERTICES = 24;
+    const int BOX_INDICES = 36;
+
+    // pise strane kvadra od zadate pozicije u vec alociranim baferima
+    struct QuadWriter {
+        Vertex* vertices;
+        unsigned int* indices;
+        unsigned int base;
+
+        // dodaje stranicu kvadra i automatski racuna normalu stranice
+        void add(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, const glm::vec3& v3,
+            const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec2& uv2, const glm::vec2& uv3)
+        {
+            glm::vec3 normal = glm::normalize(glm::cross(v2 - v0, v1 - v0));
+            *vertices++ = { v0, normal, uv0 };
+            *vertices++ = { v1, normal, uv1 };
+            *vertices++ = { v2, normal, uv2 };
+            *vertices++ = { v3, normal, uv3 };
+
+            unsigned int quad[6] = { base, base + 3, base + 2, base, base + 2, base + 1 };
+            for (unsigned int index : quad)
+                *indices++ = index;
+            base += 4;
+        }
+    };
+
+    QuadWriter writerForBox(TrackPart& part, size_t box) {
+        return { part.vertices.data() + box * BOX_VERTICES, part.indices.data() + box * BOX_INDICES, (unsigned int)(box * BOX_VERTICES) };
+    }
+
+    void resizeForBoxes(TrackPart& part, size_t boxes) {
+        part.vertices.resize(boxes * BOX_VERTICES);
+        part.indices.resize(boxes * BOX_INDICES);
+    }
+
+    // rastojanje tacke p od duzi ab
+    float distanceToSegment(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b) {
+        glm::vec3 ab = b - a;
+        float length2 = glm::dot(ab, ab);
+        float f = length2 > 0.0f ? std::clamp(glm::dot(p - a, ab) / length2, 0.0f, 1.0f) : 0.0f;
+        return glm::length(p - (a + ab * f));
+    }
+
+    // sa job sistemom paralelno, bez njega ceo opseg odjednom
+    void forRange(JobSystem* jobSystem, int begin, int end, const std::function<void(int, int)>& body) {
+        if (jobSystem)
+            jobSystem->parallelFor(begin, end, TrackGenerator::SAMPLE_GRAIN, body);
+        else if (end > begin)
+            body(begin, end);
+    }
+}
+
+TrackGenerator::TrackGenerator(Path* path, float trackWidth, float railThickness, int samples, TrackTessellation tessellation) :
+path(path),
+trackWidth(trackWidth),
+railThickness(railThickness),
+samples(samples),
+tessellation(tessellation)
+{
+}
+
+TrackGeometry TrackGenerator::generate(JobSystem* jobSystem, bool railsOnGpu) const {
+    TrackGeometry geometry;
+    auto rails = [&]() {
+        if (railsOnGpu)
+            generateRailSamples(geometry.railSamples, jobSystem);
+        else
+            generateRails(geometry.rails, jobSystem);
+    };
+    // delovi su nezavisni, pa se sa job sistemom generisu istovremeno
+    if (jobSystem) {
+        JobGraph graph;
+        graph.add(rails);
+        graph.add([&]() { generatePlanks(geometry.planks, jobSystem); });
+        graph.add([&]() { generateSleepers(geometry.sleepers, jobSystem); });
+        graph.run(*jobSystem);
+    }
+    else {
+        rails();
+        generatePlanks(geometry.planks);
+        generateSleepers(geometry.sleepers);
+    }
+    return geometry;
+}
+
+// ==================== METALNE SINE ====================
+glm::vec3 TrackGenerator::railPoint(const PathFrame& frame, int side) const
+{
+    return frame.position + (float)side * frame.normal * getRailOffset();
+}
+
+SweepProfile TrackGenerator::getRailProfile() const
+{
+    // sirina i visina jedne sine (polovine)
+    return SweepProfile::box(trackWidth * 0.1f, railThickness * 0.5f);
+}
+
+float TrackGenerator::getRailOffset() const
+{
+    return trackWidth * 0.5f;
+}
+
+void TrackGenerator::findRailKnots(int begin, int end, std::vector<int>& knots) const
+{
+    knots.push_back(begin);
+    if (tessellation.tolerance <= 0.0f) {
+        for (int i = begin + 1; i < end; i++)
+            knots.push_back(i);
+        return;
+    }
+
+    // tacke obe sine za sve uzorke opsega (i kraj)
+    std::vector<float> ts(end - begin + 1);
+    for (int i = begin; i <= end; i++)
+        ts[i - begin] = float(i) / samples;
+    std::vector<PathFrame> frames(ts.size());
+    path->getFrames(ts.data(), frames.data(), (int)ts.size());
+    std::vector<glm::vec3> left(ts.size()), right(ts.size());
+    for (size_t i = 0; i < ts.size(); i++) {
+        left[i] = railPoint(frames[i], -1);
+        right[i] = railPoint(frames[i], 1);
+    }
+
+    // kvadar od cvora se produzava uzorak po uzorak dok sve tacke izmedju ostaju u toleranciji
+    // (krivina, nagib i uvrtanje okvira se vide kao odstupanje sine od tetive)
+    auto fits = [&](int from, int to) {
+        if (glm::length(frames[to].position - frames[from].position) > tessellation.maxSegmentLength)
+            return false;
+        for (int i = from + 1; i < to; i++) {
+            if (distanceToSegment(left[i], left[from], left[to]) > tessellation.tolerance ||
+                distanceToSegment(right[i], right[from], right[to]) > tessellation.tolerance)
+                return false;
+        }
+        return true;
+    };
+    int knot = 0;
+    for (int candidate = 2; candidate <= end - begin; candidate++) {
+        if (!fits(knot, candidate)) {
+            knot = candidate - 1;
+            knots.push_back(begin + knot);
+        }
+    }
+}
+
+std::vector<std::vector<int>> TrackGenerator::findAllRailKnots(JobSystem* jobSystem) const
+{
+    int chunks = (samples + SAMPLE_GRAIN - 1) / SAMPLE_GRAIN;
+    std::vector<std::vector<int>> knots(chunks);
+    auto body = [&](int first, int last) {
+        for (int chunk = first; chunk < last; chunk++)
+            findRailKnots(chunk * SAMPLE_GRAIN, std::min((chunk + 1) * SAMPLE_GRAIN, samples), knots[chunk]);
+    };
+    if (jobSystem)
+        jobSystem->parallelFor(0, chunks, 1, body);
+    else
+        body(0, chunks);
+    return knots;
+}
+
+std::vector<float> TrackGenerator::getRailKnots(JobSystem* jobSystem) const
+{
+    std::vector<float> result;
+    for (const std::vector<int>& chunk : findAllRailKnots(jobSystem))
+        for (int knot : chunk)
+            result.push_back(float(knot) / samples);
+    result.push_back(1.0f);
+    return result;
+}
+
+void TrackGenerator::generateRails(TrackPart& part, JobSystem* jobSystem) const
+{
+    // dve sine (kvadar), svaka je jedno izvlacenje kroz sve cvorove, redom u baferu: leva pa desna
+    SweepBuilder rail(getRailProfile());
+
+    // 1) cvorovi po opsezima, 2) indeks prvog cvora opsega (prefiksna suma), 3) prstenovi i segmenti po opsezima
+    std::vector<std::vector<int>> knots = findAllRailKnots(jobSystem);
+    int chunks = (int)knots.size();
+    std::vector<size_t> offsets(chunks);
+    size_t segments = 0;
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        offsets[chunk] = segments;
+        segments += knots[chunk].size();
+    }
+    size_t rings = segments + 1;
+
+    struct Sweep {
+        const SweepBuilder* builder;
+        int side;                   // -1 leva, 1 desna
+        size_t vertexBase;
+        size_t indexBase;
+    };
+    Sweep sweeps[2] = { { &rail, -1 }, { &rail, 1 } };
+    size_t vertexCount = 0, indexCount = 0;
+    for (Sweep& sweep : sweeps) {
+        sweep.vertexBase = vertexCount;
+        sweep.indexBase = indexCount;
+        vertexCount += sweep.builder->getVertexCount(rings, true);
+        indexCount += sweep.builder->getIndexCount(rings, true);
+    }
+    part.vertices.resize(vertexCount);
+    part.indices.resize(indexCount);
+
+    auto toSweepFrame = [&](const PathFrame& frame, int side, float v) {
+        return SweepFrame{ railPoint(frame, side), frame.normal, frame.binormal, v };
+    };
+
+    auto body = [&](int first, int last) {
+        for (int chunk = first; chunk < last; chunk++) {
+            // okviri svih cvorova opsega; poslednji opseg pise i prsten na samom kraju
+            bool lastChunk = chunk == chunks - 1;
+            std::vector<float> ts;
+            for (int knot : knots[chunk])
+                ts.push_back(float(knot) / samples);
+            if (lastChunk)
+                ts.push_back(1.0f);
+            std::vector<PathFrame> frames(ts.size());
+            path->getFrames(ts.data(), frames.data(), (int)ts.size());
+
+            std::vector<SweepFrame> sweepFrames(ts.size());
+            for (const Sweep& sweep : sweeps) {
+                // v je predjeni put, tekstura se ponavlja na svaki metar
+                for (size_t k = 0; k < ts.size(); k++)
+                    sweepFrames[k] = toSweepFrame(frames[k], sweep.side, path->getDistanceAtT(ts[k]));
+                sweep.builder->writeRings(sweepFrames.data(), offsets[chunk], ts.size(),
+                    part.vertices.data() + sweep.vertexBase);
+                // segment svakog cvora ide do prvog cvora sledeceg opsega (njegov prsten pise taj opseg)
+                sweep.builder->writeSegments(offsets[chunk], knots[chunk].size(), (unsigned int)sweep.vertexBase,
+                    part.indices.data() + sweep.indexBase);
+            }
+        }
+    };
+    if (jobSystem)
+        jobSystem->parallelFor(0, chunks, 1, body);
+    else
+        body(0, chunks);
+
+    // poklopci samo na krajevima izvlacenja
+    PathFrame firstFrame = path->getFrame(0.0f);
+    PathFrame lastFrame = path->getFrame(1.0f);
+    for (const Sweep& sweep : sweeps)
+        sweep.builder->writeCaps(toSweepFrame(firstFrame, sweep.side, 0.0f),
+            toSweepFrame(lastFrame, sweep.side, path->getTotalLength()), rings, (unsigned int)sweep.vertexBase,
+            part.vertices.data() + sweep.vertexBase, part.indices.data() + sweep.indexBase);
+}
+
+void TrackGenerator::generateRailSamples(std::vector<RailSample>& result, JobSystem* jobSystem) const
+{
+    // isti cvorovi, okviri i v kao prstenovi u generateRails, presek se dodaje tek u sejderu
+    std::vector<float> ts = getRailKnots(jobSystem);
+    std::vector<PathFrame> frames(ts.size());
+    path->getFrames(ts.data(), frames.data(), (int)ts.size());
+    result.resize(ts.size());
+    for (size_t k = 0; k < ts.size(); k++) {
+        const PathFrame& frame = frames[k];
+        result[k] = {
+            glm::vec4(frame.position, path->getDistanceAtT(ts[k])),
+            glm::vec4(frame.normal, 0.0f),
+            glm::vec4(frame.binormal, 0.0f)
+        };
+    }
+}
+
+// ==================== DRVENA POPUNA - DASKE ====================
+void TrackGenerator::generatePlanks(TrackPart& part, JobSystem* jobSystem) const {
+    float desiredStep = 0.8f;                     // razmak izmedju dasaka
+
+    float plankThickness = railThickness * 0.25f; // debljina daske (vertikalno gore-dole)
+    float halfWidth = trackWidth * 0.7f;          // sirina daske
+    float plankLength = 0.25f;
+
+    // daske idu na svakih desiredStep metara (tabela duzine luka u Path), pa je svaka nezavisna:
+    // broj dasaka je poznat unapred i daska k ide na offset k
+    int plankCount = (int)(path->getTotalLength() / desiredStep);
+    resizeForBoxes(part, plankCount);
+    forRange(jobSystem, 0, plankCount, [&](int begin, int end) {
+        QuadWriter quads = writerForBox(part, begin);
+        std::vector<float> ts(end - begin);
+        for (int k = begin; k < end; k++)
+            ts[k - begin] = path->getTAtDistance((k + 1) * desiredStep);
+        std::vector<PathFrame> frames(ts.size());
+        path->getFrames(ts.data(), frames.data(), (int)ts.size());
+
+        for (int k = begin; k < end; k++) {
+            const PathFrame& frame = frames[k - begin];
+            glm::vec3 p = frame.position;
+            glm::vec3 T = frame.tangent;
+            glm::vec3 N = frame.normal;
+            glm::vec3 B = frame.binormal;
+
+            glm::vec3 frontCenter = p;
+            glm::vec3 backCenter = p - T * plankLength;
+
+            // 8 verteksa celog kvadra
+            glm::vec3 bl = backCenter - N * halfWidth + B * - plankThickness;                        // back-left-bottom
+            glm::vec3 br = backCenter + N * halfWidth + B * - plankThickness;                        // back-right-bottom
+            glm::vec3 tl = backCenter - N * halfWidth + B * + plankThickness;                        // back-left-top
+            glm::vec3 tr = backCenter + N * halfWidth + B * + plankThickness;                        // back-right-top
+
+            glm::vec3 fbl = frontCenter - N * halfWidth + B * - plankThickness;                      // front-left-bottom
+            glm::vec3 fbr = frontCenter + N * halfWidth + B * - plankThickness;                      // front-right-bottom
+            glm::vec3 ftl = frontCenter - N * halfWidth + B * + plankThickness;                      // front-left-top
+            glm::vec3 ftr = frontCenter + N * halfWidth + B * + plankThickness;                      // front-right-top
+
+            // dodavanje svih 6 strana kvadra
+            quads.add(ftl, ftr, fbr, fbl, glm::vec2(0, 1), glm::vec2(1, 1), glm::vec2(1, 0), glm::vec2(0, 0));   // front
+            quads.add(bl, br, tr, tl, glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(0, 1));       // back
+            quads.add(bl, tl, ftl, fbl, glm::vec2(0, 0), glm::vec2(0, 1), glm::vec2(1, 1), glm::vec2(1, 0));     // left
+            quads.add(br, fbr, ftr, tr, glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(0, 1));     // right
+            quads.add(fbl, fbr, br, bl, glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 1), glm::vec2(0, 1));     // bottom
+            quads.add(tl, tr, ftr, ftl, glm::vec2(0, 1), glm::vec2(1, 1), glm::vec2(1, 0), glm::vec2(0, 0));     // top
+        }
+    });
+}
+
+// ================= SLEEPERS =================
+void TrackGenerator::generateSleepers(TrackPart& part, JobSystem* jobSystem) const
+{
+    float spacing = 1.0f;   // razmak između stubova (u metrima)
+    float hw = 0.07f;       // half width (X)
+    float hd = 0.07f;       // half depth (Z)
+
+    // 1) pozicije ispod obe sine za svaki stub, na svakih spacing metara do kraja putanje
+    //    (ne i na samom kraju, tamo je pocetak); stub se ne pravi ako je sina na zemlji
+    int stations = (int)std::ceil(path->getTotalLength() / spacing);
+    std::vector<glm::vec3> railPositions(stations * 2);
+    std::vector<unsigned char> hasSleeper(stations * 2, 0);
+    forRange(jobSystem, 0, stations, [&](int begin, int end) {
+        std::vector<float> ts(end - begin);
+        for (int station = begin; station < end; station++)
+            ts[station - begin] = path->getTAtDistance(station * spacing);
+        std::vector<PathFrame> frames(ts.size());
+        path->getFrames(ts.data(), frames.data(), (int)ts.size());
+
+        for (int station = begin; station < end; station++)
+        {
+            const PathFrame& frame = frames[station - begin];
+            glm::vec3 p = frame.position;
+            glm::vec3 N = frame.normal;
+
+            for (int side = -1; side <= 1; side += 2)
+            {
+                int slot = station * 2 + (side + 1) / 2;
+                railPositions[slot] = p + (float)side * N * (trackWidth * 0.5f);
+                float y0 = 0.0f;
+                float y1 = railPositions[slot].y - 0.02f;
+                hasSleeper[slot] = y1 > y0;
+            }
+        }
+    });
+
+    // 2) offset svakog stuba (prefiksna suma)
+    std::vector<int> offsets(stations * 2);
+    int count = 0;
+    for (int slot = 0; slot < stations * 2; slot++) {
+        offsets[slot] = count;
+        count += hasSleeper[slot];
+    }
+
+    // 3) stubovi: svaki je izvlacenje kvadra od zemlje do sine (dva prstena i oba poklopca)
+    SweepBuilder sleeper(SweepProfile::box(hd, hw));
+    size_t sleeperVertices = sleeper.getVertexCount(2, true);
+    size_t sleeperIndices = sleeper.getIndexCount(2, true);
+    part.vertices.resize(count * sleeperVertices);
+    part.indices.resize(count * sleeperIndices);
+    forRange(jobSystem, 0, stations * 2, [&](int begin, int end) {
+        for (int slot = begin; slot < end; slot++)
+        {
+            if (!hasSleeper[slot])
+                continue;
+            glm::vec3 railPos = railPositions[slot];
+
+            float y0 = 0.0f;
+            float y1 = railPos.y - 0.02f;
+
+            // izvlacenje ide navise: normala z, binormala x (z x x = y), v je visina u metrima
+            SweepFrame frames[2] = {
+                { glm::vec3(railPos.x, y0, railPos.z), glm::vec3(0, 0, 1), glm::vec3(1, 0, 0), y0 },
+                { glm::vec3(railPos.x, y1, railPos.z), glm::vec3(0, 0, 1), glm::vec3(1, 0, 0), y1 }
+            };
+            size_t vertexBase = offsets[slot] * sleeperVertices;
+            Vertex* vertices = part.vertices.data() + vertexBase;
+            unsigned int* indices = part.indices.data() + offsets[slot] * sleeperIndices;
+            sleeper.writeRings(frames, 0, 2, vertices);
+            sleeper.writeSegments(0, 1, (unsigned int)vertexBase, indices);
+            sleeper.writeCaps(frames[0], frames[1], 2, (unsigned int)vertexBase, vertices, indices);
+        }
+    });
+}
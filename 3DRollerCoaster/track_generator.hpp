@@ -0,0 +1,82 @@
+#pragma once
+#include "mesh.hpp"
+#include "path.hpp"
+#include "job_system.hpp"
+#include "sweep_builder.hpp"
+#include <glm/glm.hpp>
+#include <vector>
+
+// CPU geometrija jednog dela staze
+struct TrackPart {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+};
+
+// okvir putanje u cvoru sine, za izvlacenje sina na GPU (tri RGBA32F teksela po cvoru)
+struct RailSample {
+    glm::vec4 position;     // w: predjeni put (v koordinata teksture)
+    glm::vec4 normal;
+    glm::vec4 binormal;
+};
+
+// geometrija cele staze (redosled delova je redosled mesh-eva u RollerCoaster-u)
+struct TrackGeometry {
+    TrackPart rails;
+    TrackPart planks;
+    TrackPart sleepers;
+    // samo kad se sine izvlace na GPU (rails je tada prazan)
+    std::vector<RailSample> railSamples;
+};
+
+// adaptivna podela sina: kvadar sine ide od jednog do drugog cvora (na mrezi od samples uzoraka) i produzava se
+// dok god je najvece rastojanje stvarne sine od njega do tolerance metara i duzina do maxSegmentLength;
+// tolerance 0 = ravnomerno, svaki uzorak je cvor (kao ranije)
+struct TrackTessellation {
+    float tolerance = 0.0f;
+    float maxSegmentLength = 2.0f;
+};
+
+/*
+    generisanje geometrije staze bez OpenGL-a:
+        - svaki deo se prvo prebroji (koliko kvadara ili prstenova pravi), pa se baferi alociraju odjednom
+          i svaki opseg uzoraka pise direktno na svoj unapred izracunat offset
+        - sa job sistemom se delovi i opsezi uzoraka rade paralelno, bez njega redom;
+          rezultat je isti bit po bit (isti kod po uzorku, isti redosled u baferima)
+*/
+class TrackGenerator {
+public:
+    TrackGenerator(Path* path, float trackWidth, float railThickness, int samples,
+        TrackTessellation tessellation = TrackTessellation());
+
+    // railsOnGpu: umesto geometrije sina samo okviri u cvorovima (GpuRails)
+    TrackGeometry generate(JobSystem* jobSystem = nullptr, bool railsOnGpu = false) const;
+
+    void generateRails(TrackPart& part, JobSystem* jobSystem = nullptr) const;
+    void generateRailSamples(std::vector<RailSample>& samples, JobSystem* jobSystem = nullptr) const;
+    void generatePlanks(TrackPart& part, JobSystem* jobSystem = nullptr) const;
+    void generateSleepers(TrackPart& part, JobSystem* jobSystem = nullptr) const;
+
+    // t-ovi cvorova sina redom (krajevi kvadara, ukljucujuci 0 i 1), za merenje odstupanja i broja kvadara
+    std::vector<float> getRailKnots(JobSystem* jobSystem = nullptr) const;
+    // tacka leve (side -1) ili desne (side 1) sine u okviru putanje
+    glm::vec3 railPoint(const PathFrame& frame, int side) const;
+
+    // presek koji se izvlaci duz cvorova (isti za CPU i GPU sine): kvadar, sine su railOffset levo i desno
+    SweepProfile getRailProfile() const;
+    float getRailOffset() const;
+
+    // koliko uzoraka obradjuje jedan posao
+    static const int SAMPLE_GRAIN = 512;
+
+private:
+    Path* path;
+    float trackWidth;
+    float railThickness;
+    int samples;
+    TrackTessellation tessellation;
+
+    // cvorovi za opseg uzoraka [begin, end): begin je uvek cvor, end je cvor sledeceg opsega
+    void findRailKnots(int begin, int end, std::vector<int>& knots) const;
+    // cvorovi po opsezima od SAMPLE_GRAIN uzoraka (opsezi se rade nezavisno, pa je rezultat isti sa i bez niti)
+    std::vector<std::vector<int>> findAllRailKnots(JobSystem* jobSystem) const;
+};
@@ -0,0 +1,144 @@
+#include "track_rebuilder.hpp"
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+TrackRebuilder::TrackRebuilder(RollerCoaster* rollercoaster, Cart* cart, CartMotion* cartMotion, RideSimulation* rideSimulation,
+    Path* initialPath) :
+rollercoaster(rollercoaster),
+cart(cart),
+cartMotion(cartMotion),
+rideSimulation(rideSimulation),
+currentPath(initialPath),
+requestedParams(initialPath->getParams())
+{
+}
+
+TrackRebuilder::~TrackRebuilder() {
+    if (worker.joinable())
+        worker.join();
+}
+
+PathParams TrackRebuilder::getRequestedParams() const {
+    return requestedParams;
+}
+
+bool TrackRebuilder::isBusy() const {
+    return state != State::IDLE;
+}
+
+void TrackRebuilder::requestRebuild(const PathParams& params) {
+    requestedParams = params;
+    if (state != State::IDLE) {
+        hasPending = true;
+        pendingParams = params;
+        return;
+    }
+    startGeneration(params);
+}
+
+void TrackRebuilder::startGeneration(const PathParams& params) {
+    state = State::GENERATING;
+    generated.store(false);
+    nextPath = std::make_unique<Path>(params);
+    TrackGenerator generator = rollercoaster->makeGenerator(nextPath.get());
+    bool railsOnGpu = rollercoaster->hasGpuRails();
+
+    // generisanje ide redom na svojoj niti: kroz job sistem bi glavna nit u wait() mogla da preuzme ceo posao
+    worker = std::thread([this, generator, railsOnGpu]() {
+        auto start = std::chrono::steady_clock::now();
+        nextGeometry = generator.generate(nullptr, railsOnGpu);
+        generationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        generated.store(true, std::memory_order_release);
+    });
+}
+
+void TrackRebuilder::beginUpload() {
+    if (worker.joinable())
+        worker.join();
+    uploadMeshes = rollercoaster->makeMeshes(nextGeometry, false);
+    uploadRailSamples = std::move(nextGeometry.railSamples);
+    nextGeometry = TrackGeometry();
+    for (Mesh& mesh : uploadMeshes)
+        mesh.beginUpload();
+    uploadMesh = 0;
+    uploadFrames = 0;
+    maxUploadMs = 0.0;
+    state = State::UPLOADING;
+}
+
+void TrackRebuilder::swap() {
+    Path* newPath = nextPath.get();
+    retiredPath = std::move(activePath);
+    activePath = std::move(nextPath);
+
+    rollercoaster->replaceMeshes(uploadMeshes, newPath);
+    // okviri sina su mali (par stotina KB), salju se odjednom pri zameni
+    rollercoaster->replaceRailSamples(uploadRailSamples);
+    uploadRailSamples.clear();
+    cart->setPath(newPath);
+    cartMotion->setPath(newPath);
+    // korak koji je sada u toku moze jos da koristi staru putanju, svaki sledeci pocinje sa novom
+    retireFence = rideSimulation->getTickCount() + 1;
+    currentPath = newPath;
+    state = State::IDLE;
+
+    PathParams params = newPath->getParams();
+    std::cout << "Staza ponovo generisana (";
+    if (newPath->isSpline())
+        std::cout << "iz fajla, " << params.controlPoints.size() << " kontrolnih tacaka";
+    else
+        std::cout << "duzina " << params.length << ", amplituda " << params.amplitude << ", brda " << params.hills
+            << ", nagib " << params.bankAngle;
+    std::cout << "): generisanje " << generationMs << " ms na posebnoj niti, upload u "
+        << uploadFrames << " frejmova, najduze " << maxUploadMs << " ms po frejmu" << std::endl;
+
+    if (hasPending) {
+        hasPending = false;
+        startGeneration(pendingParams);
+    }
+}
+
+bool TrackRebuilder::releaseRetiredPath() {
+    if (!retiredPath)
+        return true;
+    // bez sim niti (lockstep) koraci idu na ovoj niti, pa izmedju njih niko ne cita staru putanju
+    if (rideSimulation->isRunning() && rideSimulation->getTickCount() < retireFence)
+        return false;
+    retiredPath.reset();
+    return true;
+}
+
+void TrackRebuilder::update(size_t uploadBudgetBytes) {
+    releaseRetiredPath();
+    if (state == State::GENERATING && generated.load(std::memory_order_acquire))
+        beginUpload();
+
+    if (state != State::UPLOADING)
+        return;
+
+    // najvise uploadBudgetBytes po frejmu, mesh po mesh
+    double start = glfwGetTime();
+    size_t budget = uploadBudgetBytes;
+    while (uploadMesh < uploadMeshes.size() && budget > 0) {
+        budget -= uploadMeshes[uploadMesh].uploadChunk(budget);
+        if (uploadMeshes[uploadMesh].isUploaded())
+            uploadMesh++;
+    }
+    uploadFrames++;
+    maxUploadMs = std::max(maxUploadMs, (glfwGetTime() - start) * 1000.0);
+
+    // zamena je na granici frejma: ovaj frejm se vec crta novom stazom
+    // (ako je prethodna putanja jos u upotrebi, zamena ceka sledeci frejm)
+    if (uploadMesh >= uploadMeshes.size() && releaseRetiredPath())
+        swap();
+}
+
+void TrackRebuilder::finishNow() {
+    while (state != State::IDLE) {
+        if (state == State::GENERATING)
+            beginUpload();
+        update(SIZE_MAX);
+    }
+}
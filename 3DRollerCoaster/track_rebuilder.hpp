@@ -0,0 +1,77 @@
+#pragma once
+#include "rollercoaster.hpp"
+#include "cart.hpp"
+#include "cart_motion.hpp"
+#include "path.hpp"
+#include "ride_simulation.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*
+    promena parametara putanje u toku rada, bez zastoja u crtanju:
+        1) nova putanja i geometrija staze se prave na posebnoj niti (bez GL-a)
+        2) glavna nit na pocetku frejmova salje geometriju na GPU u komadima (glBufferSubData, ogranicen broj bajtova po frejmu)
+        3) kad je sve na GPU, na granici frejma se odjednom menjaju mesh-evi staze i putanja za kola i simulaciju
+    kola nastavljaju voznju (t se zadrzava, pa su na istom delu nove putanje)
+    zive su najvise dve putanje: trenutna i prethodna, koja se brise kad sim nit zavrsi bar jedan korak posle zamene
+    (korak koji je u toku pri zameni jos moze da cita staru); nova zamena ceka dok se prethodna ne obrise
+*/
+class TrackRebuilder {
+public:
+    TrackRebuilder(RollerCoaster* rollercoaster, Cart* cart, CartMotion* cartMotion, RideSimulation* rideSimulation,
+        Path* initialPath);
+    ~TrackRebuilder();
+
+    // nova putanja; ako je generisanje vec u toku, poslednji zahtev ceka da se ono zavrsi
+    void requestRebuild(const PathParams& params);
+    // parametri poslednjeg zahteva (ili trenutne putanje)
+    PathParams getRequestedParams() const;
+    bool isBusy() const;
+
+    // poziva se na pocetku frejma: nastavlja upload i menja stazu kad je spremna
+    void update(size_t uploadBudgetBytes = DEFAULT_UPLOAD_BUDGET);
+    // odmah zavrsava zapoceto generisanje i upload (npr. za ponovljivu reprodukciju sesije)
+    void finishNow();
+
+    static const size_t DEFAULT_UPLOAD_BUDGET = 2 * 1024 * 1024;
+
+private:
+    enum class State { IDLE, GENERATING, UPLOADING };
+
+    RollerCoaster* rollercoaster;
+    Cart* cart;
+    CartMotion* cartMotion;
+    RideSimulation* rideSimulation;
+
+    // pocetnu putanju ne poseduje rebuilder (activePath je tada prazan)
+    std::unique_ptr<Path> activePath;
+    Path* currentPath;
+    // prethodna putanja, zivi dok broj koraka simulacije ne dostigne retireFence
+    std::unique_ptr<Path> retiredPath;
+    long long retireFence = 0;
+
+    State state = State::IDLE;
+    std::thread worker;
+    std::atomic<bool> generated{ false };
+    std::unique_ptr<Path> nextPath;
+    TrackGeometry nextGeometry;
+    double generationMs = 0.0;
+
+    std::vector<Mesh> uploadMeshes;
+    std::vector<RailSample> uploadRailSamples;     // samo kad su sine na GPU
+    size_t uploadMesh = 0;
+    int uploadFrames = 0;
+    double maxUploadMs = 0.0;
+
+    bool hasPending = false;
+    PathParams pendingParams;
+    PathParams requestedParams;
+
+    void startGeneration(const PathParams& params);
+    void beginUpload();
+    void swap();
+    // brise prethodnu putanju ako je sim nit vise ne koristi; vraca da li je nema
+    bool releaseRetiredPath();
+};
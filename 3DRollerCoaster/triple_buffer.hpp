@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/*
+    lock-free trostruki bafer za jednog pisca i jednog citaoca:
+        - pisac uvek ima svoj bafer u koji pise i objavljuje ga zamenom sa "srednjim" baferom
+        - citalac preuzima srednji bafer samo ako je u njemu nesto novo
+    zamena je jedna atomska exchange operacija, pa ni jedna strana nikad ne ceka drugu
+*/
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1) {}
+
+    // pisac: bafer u koji se pise sledece stanje
+    T& writeBuffer() {
+        return buffers[writeIndex];
+    }
+
+    // pisac: objavljuje napisano stanje
+    void publish() {
+        uint8_t previous = middle.exchange(writeIndex | NEW_DATA, std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    // citalac: preuzima poslednje objavljeno stanje (ako postoji), vraca true ako je stiglo novo
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & NEW_DATA))
+            return false;
+        uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    // citalac: poslednje preuzeto stanje (ostaje validno do sledeceg update-a)
+    const T& readBuffer() const {
+        return buffers[readIndex];
+    }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t NEW_DATA = 0x4;
+
+    T buffers[3];
+    std::atomic<uint8_t> middle;
+    uint8_t writeIndex = 0;     // koristi samo pisac
+    uint8_t readIndex = 2;      // koristi samo citalac
+};